@@ -46,12 +46,26 @@
 #define xPortSysTickHandler                     isr_systick
 
 #if FREE_RTOS_KERNEL_SMP
-#define configNUMBER_OF_CORES                   1
+/* Núcleo 0: cyw43, lwIP, uplink e httpd; núcleo 1: sensores e display
+ * (afinidades em main_wifi_safe.c e cpu_cores.c) */
+#define configNUMBER_OF_CORES                   2
 #define configTICK_CORE                         0
 #define configRUN_MULTIPLE_PRIORITIES           1
 #define configUSE_CORE_AFFINITY                 1
 #endif
 
+/* Run-time stats: tempo de CPU por task em µs, pelo timer de 64 bits do
+ * RP2040 (já rodando desde o boot). O ocioso de cada núcleo vem da sua task
+ * IDLE<n> (cpu_cores.c) */
+#ifndef __ASSEMBLER__
+#include "pico/time.h"
+#endif
+#define configUSE_TRACE_FACILITY                1
+#define configGENERATE_RUN_TIME_STATS           1
+#define configRUN_TIME_COUNTER_TYPE             uint64_t
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        time_us_64()
+
 /* RP2040 specific */
 #define configSUPPORT_PICO_SYNC_INTEROP         1
 #define configSUPPORT_PICO_TIME_INTEROP         1
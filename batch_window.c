@@ -0,0 +1,143 @@
+/**
+ * Janela de retransmissão dos lotes do uplink
+ *
+ * Cada lote recebe uma sequência e fica retido até que o ACK cumulativo do
+ * servidor (maior sequência contígua gravada) o cubra. Falhas e timeouts
+ * devolvem o lote para a fila de envio; o servidor descarta duplicatas.
+ * Acessada pelo http_task e pelo callback do uplink (contexto do lwIP).
+ */
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "batch_window.h"
+
+static batch_entry_t entries[BATCH_WINDOW_SIZE];
+static uint32_t stream_id = 0;
+static uint32_t next_seq = 0;
+static uint32_t base_seq = 0;       // Menor sequência ainda retida
+static batch_window_stats_t stats;
+
+// Sequências crescem sem limite prático (um lote a cada poucos segundos), mas
+// a comparação tolera a volta do contador
+static bool seq_before_eq(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) <= 0;
+}
+
+static batch_entry_t *entry_for(uint32_t seq) {
+    return &entries[seq % BATCH_WINDOW_SIZE];
+}
+
+// Pula entradas liberadas pelo ACK ou sobrescritas por um lote mais novo
+static void advance_base(void) {
+    while (base_seq != next_seq) {
+        const batch_entry_t *e = entry_for(base_seq);
+        if (e->state != BATCH_FREE && e->seq == base_seq) {
+            break;
+        }
+        base_seq++;
+    }
+}
+
+void batch_window_init(uint32_t id) {
+    taskENTER_CRITICAL();
+    memset(entries, 0, sizeof(entries));
+    memset(&stats, 0, sizeof(stats));
+    stream_id = id;
+    next_seq = 0;
+    base_seq = 0;
+    taskEXIT_CRITICAL();
+}
+
+uint32_t batch_window_stream_id(void) {
+    return stream_id;
+}
+
+uint32_t batch_window_push(const SensorData *samples, size_t count) {
+    if (count > BATCH_WINDOW_MAX_SAMPLES) {
+        count = BATCH_WINDOW_MAX_SAMPLES;
+    }
+
+    taskENTER_CRITICAL();
+    uint32_t seq = next_seq++;
+    batch_entry_t *e = entry_for(seq);
+    if (e->state != BATCH_FREE) {
+        // Janela cheia: o lote mais antigo (seq - SIZE) não será mais enviado
+        stats.dropped_batches++;
+        stats.dropped_samples += e->count;
+    }
+
+    e->state = BATCH_PENDING;
+    e->seq = seq;
+    e->sends = 0;
+    e->count = (uint8_t)count;
+    memcpy(e->samples, samples, count * sizeof(SensorData));
+    advance_base();
+    stats.pushed++;
+    taskEXIT_CRITICAL();
+    return seq;
+}
+
+bool batch_window_take(batch_entry_t *out, uint32_t *base, uint32_t now_ms) {
+    bool found = false;
+
+    taskENTER_CRITICAL();
+    for (uint32_t seq = base_seq; seq != next_seq; seq++) {
+        batch_entry_t *e = entry_for(seq);
+        bool redeliver = e->state == BATCH_DELIVERED &&
+                         now_ms - e->delivered_ms >= BATCH_WINDOW_REDELIVER_MS;
+        if (e->state == BATCH_PENDING || redeliver) {
+            if (e->sends) {
+                stats.retransmits++;
+            }
+            e->state = BATCH_IN_FLIGHT;
+            e->sends++;
+            stats.sent++;
+            *out = *e;
+            *base = base_seq;
+            found = true;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return found;
+}
+
+void batch_window_result(uint32_t seq, bool ok, bool has_ack, uint32_t ack, uint32_t now_ms) {
+    taskENTER_CRITICAL();
+    batch_entry_t *e = entry_for(seq);
+    // O lote pode ter sido descartado (janela cheia) enquanto estava em curso
+    if (e->state == BATCH_IN_FLIGHT && e->seq == seq) {
+        if (ok) {
+            e->state = BATCH_DELIVERED;
+            e->delivered_ms = now_ms;
+        } else {
+            e->state = BATCH_PENDING;
+        }
+    }
+
+    if (has_ack && seq_before_eq(ack, next_seq - 1)) {
+        for (uint32_t s = base_seq; s != next_seq && seq_before_eq(s, ack); s++) {
+            batch_entry_t *acked = entry_for(s);
+            if (acked->state != BATCH_FREE) {
+                acked->state = BATCH_FREE;
+                stats.acked++;
+            }
+        }
+        stats.last_ack = ack;
+        advance_base();
+    }
+    taskEXIT_CRITICAL();
+}
+
+bool batch_window_busy(void) {
+    return base_seq != next_seq;
+}
+
+void batch_window_get_stats(batch_window_stats_t *out) {
+    taskENTER_CRITICAL();
+    *out = stats;
+    out->in_window = next_seq - base_seq;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,62 @@
+#ifndef BATCH_WINDOW_H
+#define BATCH_WINDOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sample_codec.h"
+
+// Lotes retidos até o ACK do servidor (o mais antigo é descartado se encher)
+#define BATCH_WINDOW_SIZE           8
+#define BATCH_WINDOW_MAX_SAMPLES    8
+// Lote aceito (2xx) mas ainda não coberto pelo ACK cumulativo: reenvia após
+// esse prazo, caso o servidor tenha perdido o estado
+#define BATCH_WINDOW_REDELIVER_MS   30000
+
+typedef enum {
+	BATCH_FREE = 0,
+	BATCH_PENDING,      // Aguardando (re)envio
+	BATCH_IN_FLIGHT,    // Requisição em curso
+	BATCH_DELIVERED,    // Servidor respondeu 2xx, aguardando ACK cumulativo
+} batch_state_t;
+
+typedef struct {
+	batch_state_t state;
+	uint32_t seq;
+	uint32_t delivered_ms;
+	uint8_t sends;
+	uint8_t count;
+	SensorData samples[BATCH_WINDOW_MAX_SAMPLES];
+} batch_entry_t;
+
+typedef struct {
+	uint32_t pushed;
+	uint32_t sent;
+	uint32_t retransmits;
+	uint32_t acked;                 // Lotes liberados pelo ACK
+	uint32_t dropped_batches;       // Descartados com a janela cheia
+	uint32_t dropped_samples;
+	uint32_t last_ack;
+	uint32_t in_window;
+} batch_window_stats_t;
+
+// ID do stream (sorteado por boot); as sequências recomeçam em 0
+void batch_window_init(uint32_t stream_id);
+uint32_t batch_window_stream_id(void);
+
+// Guarda um lote novo e atribui a próxima sequência
+uint32_t batch_window_push(const SensorData *samples, size_t count);
+
+// Copia o próximo lote a enviar (menor sequência pendente) e o marca em curso;
+// base_seq recebe a menor sequência ainda retida
+bool batch_window_take(batch_entry_t *out, uint32_t *base_seq, uint32_t now_ms);
+
+// Resultado de uma requisição: ok = 2xx; ack = maior sequência contígua
+// gravada pelo servidor (has_ack = false se a resposta não trouxe ACK)
+void batch_window_result(uint32_t seq, bool ok, bool has_ack, uint32_t ack, uint32_t now_ms);
+
+bool batch_window_busy(void);
+void batch_window_get_stats(batch_window_stats_t *stats);
+
+#endif // BATCH_WINDOW_H
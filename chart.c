@@ -0,0 +1,118 @@
+/**
+ * Gráfico de histórico no SSD1306, uma coluna por amostra
+ *
+ * O deslocamento é circular na própria área do gráfico: em vez de mover o
+ * desenho inteiro a cada amostra, o cursor avança uma coluna e sobrescreve a
+ * mais antiga. O scroll horizontal do controlador (0x26/0x27) não serve
+ * aqui: ele anda sozinho no ritmo dos quadros do painel, não por amostra, e
+ * deixaria a RAM do painel diferente da cópia que o ssd1306_show() compara.
+ * A escala acompanha o mínimo e o máximo visíveis em múltiplos de step, e só
+ * uma mudança nela redesenha a área toda.
+ */
+
+#include <string.h>
+
+#include "chart.h"
+
+static uint8_t value_row(const chart_t *chart, uint16_t value) {
+    uint32_t span = (uint32_t)(chart->hi - chart->lo);
+    uint32_t offset = (uint32_t)(value - chart->lo) * (chart->height - 1u) / span;
+    return (uint8_t)(chart->height - 1u - offset);     // Linha 0 em cima
+}
+
+// Amostra da coluna ligada à anterior por um segmento vertical; a coluna do
+// cursor e a que vem depois dela (a mais antiga) não têm ligação
+static void draw_col(chart_t *chart, ssd1306_t *canvas, uint8_t col) {
+    uint32_t bits = 0;
+    uint16_t value = chart->samples[col];
+
+    if (col != chart->head && value != CHART_NO_VALUE) {
+        uint8_t row = value_row(chart, value);
+        uint8_t top = row;
+        uint8_t bottom = row;
+        uint8_t prev = (uint8_t)(col == 0 ? chart->width - 1 : col - 1);
+        if (prev != chart->head && chart->samples[prev] != CHART_NO_VALUE) {
+            uint8_t prev_row = value_row(chart, chart->samples[prev]);
+            top = prev_row < top ? prev_row : top;
+            bottom = prev_row > bottom ? prev_row : bottom;
+        }
+        bits = ((1u << (bottom - top + 1)) - 1u) << top;
+    }
+    ssd1306_draw_column(canvas, (int16_t)(chart->x + col), chart->y, chart->height, bits);
+    chart->stats.columns++;
+}
+
+// Escala que contém as amostras visíveis; false se nada mudou
+static bool update_scale(chart_t *chart) {
+    uint16_t min = CHART_NO_VALUE;
+    uint16_t max = 0;
+    for (uint8_t col = 0; col < chart->width; col++) {
+        uint16_t value = chart->samples[col];
+        if (value == CHART_NO_VALUE) {
+            continue;
+        }
+        if (value < min) {
+            min = value;
+        }
+        if (value > max) {
+            max = value;
+        }
+    }
+    if (min == CHART_NO_VALUE) {
+        return false;   // Só falhas: mantém a escala anterior
+    }
+
+    uint16_t lo = (uint16_t)(min / chart->step * chart->step);
+    uint32_t hi = ((uint32_t)max / chart->step + 1u) * chart->step;
+    if (hi >= CHART_NO_VALUE) {
+        hi = CHART_NO_VALUE - 1u;
+    }
+    if (chart->drawn && lo == chart->lo && hi == chart->hi) {
+        return false;
+    }
+    chart->lo = lo;
+    chart->hi = (uint16_t)hi;
+    return true;
+}
+
+void chart_init(chart_t *chart, int16_t x, int16_t y, uint8_t width, uint8_t height,
+                uint16_t step) {
+    memset(chart, 0, sizeof(*chart));
+    chart->x = x;
+    chart->y = y;
+    chart->width = width > CHART_MAX_WIDTH ? CHART_MAX_WIDTH : (width < 2 ? 2 : width);
+    chart->height = height > SSD1306_COLUMN_MAX_HEIGHT ? SSD1306_COLUMN_MAX_HEIGHT : height;
+    chart->step = step ? step : 1;
+    chart->hi = chart->step;
+    for (uint8_t col = 0; col < CHART_MAX_WIDTH; col++) {
+        chart->samples[col] = CHART_NO_VALUE;
+    }
+}
+
+void chart_reset(chart_t *chart, ssd1306_t *canvas) {
+    chart_init(chart, chart->x, chart->y, chart->width, chart->height, chart->step);
+    for (uint8_t col = 0; col < chart->width; col++) {
+        ssd1306_draw_column(canvas, (int16_t)(chart->x + col), chart->y, chart->height, 0);
+    }
+}
+
+void chart_push(chart_t *chart, ssd1306_t *canvas, uint16_t value) {
+    uint8_t col = chart->head;
+    chart->samples[col] = value;
+    chart->head = (uint8_t)((col + 1) % chart->width);
+    // O cursor esconde a amostra mais antiga; ela sai também da escala
+    chart->samples[chart->head] = CHART_NO_VALUE;
+    chart->stats.pushes++;
+
+    if (update_scale(chart)) {
+        for (uint8_t c = 0; c < chart->width; c++) {
+            draw_col(chart, canvas, c);
+        }
+        chart->drawn = true;
+        chart->stats.redraws++;
+        return;
+    }
+    draw_col(chart, canvas, col);
+    draw_col(chart, canvas, chart->head);
+    draw_col(chart, canvas, (uint8_t)((chart->head + 1) % chart->width));
+}
@@ -0,0 +1,43 @@
+#ifndef CHART_H
+#define CHART_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+#define CHART_MAX_WIDTH         SSD1306_WIDTH
+#define CHART_NO_VALUE          0xFFFF      // Leitura inválida: coluna vazia
+
+typedef struct {
+	uint32_t pushes;            // chart_push()
+	uint32_t redraws;           // Redesenhos inteiros (escala mudou)
+	uint32_t columns;           // Colunas gravadas no framebuffer
+} chart_stats_t;
+
+// Histórico em varredura: cada amostra grava uma coluna e o cursor anda para
+// a direita, voltando ao início (como um osciloscópio). A coluna depois do
+// cursor fica vazia e separa o mais novo do mais antigo
+typedef struct {
+	int16_t x;
+	int16_t y;
+	uint8_t width;              // Colunas = amostras visíveis + 1 (cursor)
+	uint8_t height;             // Até SSD1306_COLUMN_MAX_HEIGHT
+	uint16_t step;              // Os limites da escala são múltiplos de step
+	uint16_t lo;                // Valor na linha de baixo
+	uint16_t hi;                // Valor na linha de cima
+	uint8_t head;               // Coluna do cursor (a próxima a gravar)
+	bool drawn;                 // A escala atual já está no framebuffer
+	uint16_t samples[CHART_MAX_WIDTH];  // Por coluna de tela
+	chart_stats_t stats;
+} chart_t;
+
+void chart_init(chart_t *chart, int16_t x, int16_t y, uint8_t width, uint8_t height,
+                uint16_t step);
+// Acrescenta uma amostra (CHART_NO_VALUE = falha). Normalmente grava só três
+// colunas vizinhas (nova, cursor e a mais antiga, que perde a ligação);
+// redesenha tudo apenas quando a escala muda
+void chart_push(chart_t *chart, ssd1306_t *canvas, uint16_t value);
+// Esquece o histórico e apaga a área
+void chart_reset(chart_t *chart, ssd1306_t *canvas);
+
+#endif // CHART_H
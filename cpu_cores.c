@@ -0,0 +1,132 @@
+/**
+ * Afinidade das tasks e ocupação por núcleo (FreeRTOS SMP no RP2040)
+ *
+ * As tasks da aplicação nascem fixadas pelo cpu_cores_create_task(); as da
+ * pilha de rede (async context do cyw43, tcpip do lwIP) e a de timers do
+ * kernel nascem sem afinidade e são fixadas no núcleo de rede depois. A
+ * ocupação vem dos run-time stats: cada núcleo tem a sua task IDLE<n>, e
+ * fixando cada uma no próprio núcleo o tempo dela passa a ser exatamente o
+ * ocioso daquele núcleo. O kernel só soma o tempo de uma task quando ela sai
+ * da CPU, então cada núcleo fecha a própria janela a partir de uma task que
+ * roda nele: nesse momento a IDLE dele está fora da CPU e o contador dela está
+ * em dia.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "pico/stdlib.h"
+
+#include "cpu_cores.h"
+
+#define SMP_AFFINITY    ((configUSE_CORE_AFFINITY == 1) && (configNUMBER_OF_CORES > 1))
+
+// Nome das idle tasks no SMP: configIDLE_TASK_NAME ("IDLE") + número do núcleo
+#define IDLE_NAME       "IDLE"
+#define IDLE_NAME_LEN   4
+
+static cpu_cores_stats_t stats;
+static TaskHandle_t idle_tasks[2];
+static uint64_t last_idle_us[2];
+static uint64_t last_update_us[2];
+
+// Núcleo da idle task com esse nome, ou -1. Com um núcleo só ela é "IDLE"
+static int idle_core(const char *name) {
+    if (strncmp(name, IDLE_NAME, IDLE_NAME_LEN) != 0) {
+        return -1;
+    }
+    char digit = name[IDLE_NAME_LEN];
+    if (digit == '\0') {
+        return configNUMBER_OF_CORES == 1 ? 0 : -1;
+    }
+    if (digit < '0' || digit >= '0' + configNUMBER_OF_CORES || digit >= '0' + 2 ||
+        name[IDLE_NAME_LEN + 1] != '\0') {
+        return -1;
+    }
+    return digit - '0';
+}
+
+BaseType_t cpu_cores_create_task(TaskFunction_t code, const char *name, uint32_t stack,
+                                 void *params, UBaseType_t priority, UBaseType_t core,
+                                 TaskHandle_t *handle) {
+#if SMP_AFFINITY
+    return xTaskCreateAffinitySet(code, name, stack, params, priority, (UBaseType_t)1 << core,
+                                  handle);
+#else
+    (void)core;
+    return xTaskCreate(code, name, stack, params, priority, handle);
+#endif
+}
+
+void cpu_cores_pin_unpinned(UBaseType_t default_core) {
+    static TaskStatus_t tasks[CPU_CORES_MAX_TASKS];
+    uint32_t pinned = 0;
+
+    UBaseType_t count = uxTaskGetSystemState(tasks, CPU_CORES_MAX_TASKS, NULL);
+    for (UBaseType_t i = 0; i < count; i++) {
+        const char *name = tasks[i].pcTaskName;
+        int core = idle_core(name);
+        if (core >= 0) {
+            idle_tasks[core] = tasks[i].xHandle;
+#if SMP_AFFINITY
+            vTaskCoreAffinitySet(tasks[i].xHandle, (UBaseType_t)1 << core);
+#endif
+            continue;
+        }
+#if SMP_AFFINITY
+        if (tasks[i].uxCoreAffinityMask == tskNO_AFFINITY) {
+            vTaskCoreAffinitySet(tasks[i].xHandle, (UBaseType_t)1 << default_core);
+            pinned++;
+        }
+#else
+        (void)default_core;
+#endif
+    }
+    if (count == 0) {
+        printf("CPU: Aviso - mais de %d tasks, afinidades nao ajustadas\n", CPU_CORES_MAX_TASKS);
+    }
+
+    taskENTER_CRITICAL();
+    stats = (cpu_cores_stats_t){ .cores = configNUMBER_OF_CORES, .pinned = pinned };
+    for (int core = 0; core < configNUMBER_OF_CORES && core < 2; core++) {
+        last_idle_us[core] = 0;
+        last_update_us[core] = 0;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void cpu_cores_update(void) {
+    unsigned int core = get_core_num();
+    if (core >= 2 || !idle_tasks[core]) {
+        return;     // cpu_cores_pin_unpinned() ainda não rodou
+    }
+    // Quem chama está neste núcleo, então a IDLE dele não está rodando
+    uint64_t idle_us = ulTaskGetRunTimeCounter(idle_tasks[core]);
+    uint64_t now = time_us_64();
+
+    taskENTER_CRITICAL();
+    if (last_update_us[core] == 0) {
+        // Primeira janela deste núcleo: só marca o início
+        last_idle_us[core] = idle_us;
+        last_update_us[core] = now;
+    } else if (now > last_update_us[core]) {
+        uint64_t elapsed = now - last_update_us[core];
+        uint64_t idle = idle_us - last_idle_us[core];
+        uint64_t busy = idle < elapsed ? elapsed - idle : 0;
+        stats.busy_us[core] += busy;
+        stats.tracked_us[core] += elapsed;
+        stats.busy_permille[core] = (uint32_t)(busy * 1000 / elapsed);
+        stats.window_ms[core] = (uint32_t)(elapsed / 1000);
+        last_idle_us[core] = idle_us;
+        last_update_us[core] = now;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void cpu_cores_get_stats(cpu_cores_stats_t *out) {
+    taskENTER_CRITICAL();
+    *out = stats;
+    taskEXIT_CRITICAL();
+}
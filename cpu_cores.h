@@ -0,0 +1,42 @@
+#ifndef CPU_CORES_H
+#define CPU_CORES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Divisão entre os dois núcleos do RP2040: rede (cyw43, lwIP, uplink, httpd)
+// no 0, que também recebe o tick; sensores e display no 1, longe das rajadas
+// do rádio
+#define CPU_CORE_NET            0
+#define CPU_CORE_IO             1
+// Tasks que cpu_cores_pin_unpinned() consegue percorrer
+#define CPU_CORES_MAX_TASKS     24
+
+typedef struct {
+	uint32_t cores;             // configNUMBER_OF_CORES
+	uint32_t pinned;            // Tasks sem afinidade fixadas no núcleo de rede
+	uint64_t busy_us[2];        // Tempo fora da IDLE<n>, acumulado
+	uint64_t tracked_us[2];     // Tempo medido em cada núcleo
+	uint32_t busy_permille[2];  // Na última janela do núcleo
+	uint32_t window_ms[2];      // Duração dessa janela
+} cpu_cores_stats_t;
+
+// xTaskCreate() fixada em um núcleo (no build de um núcleo só, sem afinidade)
+BaseType_t cpu_cores_create_task(TaskFunction_t code, const char *name, uint32_t stack,
+                                 void *params, UBaseType_t priority, UBaseType_t core,
+                                 TaskHandle_t *handle);
+
+// Fixa cada IDLE<n> no núcleo n, para que o tempo dela seja o ocioso daquele
+// núcleo, e as tasks ainda sem afinidade (cyw43, tcpip, timers) no núcleo
+// default_core. Chamar depois que a pilha de rede criou as suas tasks
+void cpu_cores_pin_unpinned(UBaseType_t default_core);
+
+// Fecha a janela de medição do núcleo em que é chamada (ocupação desde a
+// chamada anterior nele). Precisa ser chamada periodicamente de uma task de
+// cada núcleo: o contador da IDLE só está em dia com ela fora da CPU
+void cpu_cores_update(void);
+void cpu_cores_get_stats(cpu_cores_stats_t *out);
+
+#endif // CPU_CORES_H
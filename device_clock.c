@@ -0,0 +1,112 @@
+/**
+ * Relógio de 64 bits em µs disciplinado por SNTP
+ *
+ * Entre sincronizações o tempo é extrapolado a partir do timer de µs do
+ * RP2040 com uma correção de frequência (ppb): o drift estimado do cristal
+ * mais um slew que absorve o último offset em DEVICE_CLOCK_SLEW_WINDOW_US,
+ * sem saltos para trás. Offsets grandes (primeira sincronização, servidor
+ * trocado) são aplicados de uma vez.
+ */
+
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "pico/stdlib.h"
+
+#include "device_clock.h"
+
+// Âncora: horário do relógio disciplinado no instante anchor_mono_us do timer
+static uint64_t anchor_mono_us = 0;
+static uint64_t anchor_clock_us = 0;
+static uint64_t last_sync_mono_us = 0;
+static int32_t slew_ppb = 0;
+static device_clock_stats_t stats;
+
+static int32_t clamp_ppb(int64_t ppb) {
+    if (ppb > DEVICE_CLOCK_MAX_PPB) {
+        return DEVICE_CLOCK_MAX_PPB;
+    }
+    if (ppb < -DEVICE_CLOCK_MAX_PPB) {
+        return -DEVICE_CLOCK_MAX_PPB;
+    }
+    return (int32_t)ppb;
+}
+
+static uint64_t clock_at(uint64_t mono_us) {
+    int64_t elapsed = (int64_t)(mono_us - anchor_mono_us);
+    int64_t slewed = elapsed < DEVICE_CLOCK_SLEW_WINDOW_US ? elapsed : DEVICE_CLOCK_SLEW_WINDOW_US;
+    int64_t correction = (elapsed * stats.drift_ppb + slewed * slew_ppb) / 1000000000;
+    return anchor_clock_us + (uint64_t)(elapsed + correction);
+}
+
+uint64_t device_clock_now_us(void) {
+    taskENTER_CRITICAL();
+    uint64_t now = clock_at(time_us_64());
+    taskEXIT_CRITICAL();
+    return now;
+}
+
+uint64_t device_clock_now_ms(void) {
+    return device_clock_now_us() / 1000;
+}
+
+uint64_t device_clock_absolute_ms(uint64_t timestamp_ms) {
+    if (timestamp_ms >= DEVICE_CLOCK_EPOCH_MIN_MS || !stats.synced) {
+        return timestamp_ms;
+    }
+    // Antes da primeira sincronização o relógio era o próprio timer do boot
+    taskENTER_CRITICAL();
+    uint64_t absolute = clock_at(timestamp_ms * 1000);
+    taskEXIT_CRITICAL();
+    return absolute / 1000;
+}
+
+void device_clock_sync(uint64_t reference_us) {
+    taskENTER_CRITICAL();
+    uint64_t mono = time_us_64();
+    uint64_t local = clock_at(mono);
+    int64_t offset = (int64_t)(reference_us - local);
+
+    if (!stats.synced || llabs(offset) > DEVICE_CLOCK_STEP_US) {
+        anchor_clock_us = reference_us;
+        slew_ppb = 0;
+        stats.steps++;
+    } else {
+        // O offset restante é erro de frequência não modelado desde a última
+        // sincronização; ganho de 1/4 para não seguir o jitter da rede
+        int64_t interval = (int64_t)(mono - last_sync_mono_us);
+        if (interval > 0) {
+            stats.drift_ppb = clamp_ppb(stats.drift_ppb + offset * 1000000000 / interval / 4);
+        }
+        anchor_clock_us = local;
+        slew_ppb = clamp_ppb(offset * 1000000000 / DEVICE_CLOCK_SLEW_WINDOW_US);
+        if ((uint64_t)llabs(offset) > stats.max_abs_offset_us) {
+            stats.max_abs_offset_us = (uint64_t)llabs(offset);
+        }
+    }
+    anchor_mono_us = mono;
+    last_sync_mono_us = mono;
+
+    stats.synced = true;
+    stats.syncs++;
+    stats.last_offset_us = offset;
+    stats.rate_ppb = clamp_ppb((int64_t)stats.drift_ppb + slew_ppb);
+    stats.last_sync_us = reference_us;
+    taskEXIT_CRITICAL();
+}
+
+void device_clock_get_stats(device_clock_stats_t *out) {
+    taskENTER_CRITICAL();
+    *out = stats;
+    taskEXIT_CRITICAL();
+}
+
+void device_clock_sntp_set(uint32_t sec, uint32_t us) {
+    device_clock_sync((uint64_t)sec * 1000000 + us);
+}
+
+void device_clock_sntp_get(uint32_t *sec, uint32_t *us) {
+    uint64_t now = device_clock_now_us();
+    *sec = (uint32_t)(now / 1000000);
+    *us = (uint32_t)(now % 1000000);
+}
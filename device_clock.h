@@ -0,0 +1,47 @@
+#ifndef DEVICE_CLOCK_H
+#define DEVICE_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Relógio do dispositivo em µs desde 1970 (UTC), disciplinado por SNTP.
+// Antes da primeira sincronização conta a partir do boot; qualquer valor
+// abaixo de DEVICE_CLOCK_EPOCH_MIN_MS é, portanto, relativo ao boot.
+#define DEVICE_CLOCK_EPOCH_MIN_MS   1000000000000ull   // 2001-09-09
+
+// Offsets acima disso causam salto (step); abaixo, correção gradual (slew)
+#define DEVICE_CLOCK_STEP_US        128000
+// Intervalo em que um offset pequeno é absorvido pela correção de frequência;
+// STEP_US / SLEW_WINDOW_US = MAX_PPB, então todo offset abaixo do step cabe
+#define DEVICE_CLOCK_SLEW_WINDOW_US 256000000ll
+// Limite da correção de frequência (drift + slew), em partes por bilhão
+#define DEVICE_CLOCK_MAX_PPB        500000
+
+typedef struct {
+	bool synced;
+	uint32_t syncs;
+	uint32_t steps;
+	int64_t last_offset_us;     // Referência - relógio local na última sincronização
+	uint64_t max_abs_offset_us; // Maior |offset| corrigido por slew
+	int32_t drift_ppb;          // Erro de frequência estimado do cristal
+	int32_t rate_ppb;           // Correção aplicada agora (drift + slew)
+	uint64_t last_sync_us;      // Horário (relógio disciplinado) da última sincronização
+} device_clock_stats_t;
+
+uint64_t device_clock_now_us(void);
+uint64_t device_clock_now_ms(void);
+
+// Converte um timestamp relativo ao boot (ms) para o relógio absoluto, se já
+// sincronizado; timestamps absolutos são devolvidos sem alteração
+uint64_t device_clock_absolute_ms(uint64_t timestamp_ms);
+
+// Nova referência de tempo (chamado pelo SNTP, contexto do lwIP)
+void device_clock_sync(uint64_t reference_us);
+
+void device_clock_get_stats(device_clock_stats_t *stats);
+
+// Ganchos do SNTP do lwIP (SNTP_SET_SYSTEM_TIME_US / SNTP_GET_SYSTEM_TIME em lwipopts.h)
+void device_clock_sntp_set(uint32_t sec, uint32_t us);
+void device_clock_sntp_get(uint32_t *sec, uint32_t *us);
+
+#endif // DEVICE_CLOCK_H
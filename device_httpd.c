@@ -0,0 +1,392 @@
+/**
+ * Servidor HTTP embarcado para clientes "pull"
+ *
+ * Os handlers CGI do httpd do lwIP só traduzem /latest, /history e /metrics
+ * para nomes com extensão (para o Content-Type); o conteúdo é gerado em
+ * fs_open_custom() dentro de buffers estáticos, sem alocação por requisição.
+ */
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/apps/fs.h"
+#include "lwip/apps/httpd.h"
+
+#include "batch_window.h"
+#include "device_clock.h"
+#include "device_httpd.h"
+#include "cpu_cores.h"
+#include "display.h"
+#include "radio_window.h"
+#include "sample_ring.h"
+#include "sampling_ctl.h"
+#include "server_pool.h"
+#include "uplink.h"
+
+typedef struct {
+    char data[DEVICE_HTTPD_BUF_SIZE];
+    size_t len;
+    bool truncated;             // put_*() descartou bytes por falta de espaço
+    bool in_use;
+} httpd_slot_t;
+
+typedef struct {
+    uint32_t requests;
+    uint32_t busy;              // Sem slot livre (404)
+    uint32_t metrics_truncated; // /metrics maior que o buffer
+    uint32_t rps_last;          // Requisições no último segundo completo
+    uint32_t rps_max;
+    uint32_t window_start_ms;
+    uint32_t window_count;
+} httpd_stats_t;
+
+static httpd_slot_t slots[DEVICE_HTTPD_SLOTS];
+static httpd_stats_t stats;
+static uint32_t history_n = 1;
+static uint32_t wifi_connect_ms = 0;
+static bool wifi_fast_path = false;
+static const rate_ctl_t *uplink_rate = NULL;
+
+// ==================== Formatação ====================
+static void put_str(httpd_slot_t *slot, const char *str) {
+    while (*str && slot->len < DEVICE_HTTPD_BUF_SIZE) {
+        slot->data[slot->len++] = *str++;
+    }
+    if (*str) {
+        slot->truncated = true;
+    }
+}
+
+static void put_uint(httpd_slot_t *slot, uint64_t value) {
+    uint64_t div = 1;
+    while (value / div >= 10) {
+        div *= 10;
+    }
+    do {
+        if (slot->len < DEVICE_HTTPD_BUF_SIZE) {
+            slot->data[slot->len++] = (char)('0' + (value / div) % 10);
+        } else {
+            slot->truncated = true;
+        }
+        div /= 10;
+    } while (div > 0);
+}
+
+static void put_metric(httpd_slot_t *slot, const char *name, uint64_t value) {
+    put_str(slot, name);
+    put_str(slot, " ");
+    put_uint(slot, value);
+    put_str(slot, "\n");
+}
+
+static void put_metric_int(httpd_slot_t *slot, const char *name, int64_t value) {
+    put_str(slot, name);
+    put_str(slot, value < 0 ? " -" : " ");
+    put_uint(slot, value < 0 ? 0 - (uint64_t)value : (uint64_t)value);
+    put_str(slot, "\n");
+}
+
+// Métrica por núcleo: nome{core="i"} valor
+static void put_core_metric(httpd_slot_t *slot, const char *name, int core, uint64_t value) {
+    put_str(slot, name);
+    put_str(slot, "{core=\"");
+    put_uint(slot, (uint64_t)core);
+    put_str(slot, "\"} ");
+    put_uint(slot, value);
+    put_str(slot, "\n");
+}
+
+// Métrica por servidor de ingestão: nome{server="i"} valor
+static void put_server_metric(httpd_slot_t *slot, const char *name, int index, uint64_t value) {
+    put_str(slot, name);
+    put_str(slot, "{server=\"");
+    put_uint(slot, (uint64_t)index);
+    put_str(slot, "\"} ");
+    put_uint(slot, value);
+    put_str(slot, "\n");
+}
+
+// Maior amostra em JSON (timestamp de 20 dígitos + 5 canais de 5 + cor)
+#define SAMPLE_JSON_MAX 112
+
+static void put_sample_json(httpd_slot_t *slot, const SensorData *s) {
+    put_str(slot, "{\"t\":");
+    put_uint(slot, s->timestamp_ms);
+    put_str(slot, ",\"r\":");
+    put_uint(slot, s->red);
+    put_str(slot, ",\"g\":");
+    put_uint(slot, s->green);
+    put_str(slot, ",\"b\":");
+    put_uint(slot, s->blue);
+    put_str(slot, ",\"c\":");
+    put_uint(slot, s->clear);
+    put_str(slot, ",\"dist\":");
+    put_uint(slot, s->distance);
+    put_str(slot, ",\"cor\":\"");
+    put_str(slot, s->color_id < SAMPLE_COLOR_COUNT ? sample_color_names[s->color_id] : "?");
+    put_str(slot, "\"}");
+}
+
+// ==================== Geradores ====================
+static void render_latest(httpd_slot_t *slot) {
+    SensorData sample;
+    if (sample_ring_latest(&sample, 1) == 0) {
+        put_str(slot, "{}");
+        return;
+    }
+    put_sample_json(slot, &sample);
+}
+
+static void render_history(httpd_slot_t *slot) {
+    static SensorData samples[SAMPLE_RING_SIZE];
+    size_t count = sample_ring_latest(samples, history_n);
+
+    put_str(slot, "[");
+    for (size_t i = 0; i < count; i++) {
+        if (slot->len + SAMPLE_JSON_MAX + 2 > DEVICE_HTTPD_BUF_SIZE) {
+            break;
+        }
+        if (i) {
+            put_str(slot, ",");
+        }
+        put_sample_json(slot, &samples[i]);
+    }
+    put_str(slot, "]");
+}
+
+// Sem espaço: volta até a última linha completa que deixa lugar para a marca
+#define METRICS_TRUNCATED_LINE "metrics_truncated 1\n"
+
+static void finish_metrics(httpd_slot_t *slot) {
+    if (!slot->truncated) {
+        return;
+    }
+    stats.metrics_truncated++;
+    size_t len = DEVICE_HTTPD_BUF_SIZE - (sizeof(METRICS_TRUNCATED_LINE) - 1);
+    if (slot->len < len) {
+        len = slot->len;
+    }
+    while (len > 0 && slot->data[len - 1] != '\n') {
+        len--;
+    }
+    slot->len = len;
+    put_str(slot, METRICS_TRUNCATED_LINE);
+}
+
+static void render_metrics(httpd_slot_t *slot) {
+    uplink_stats_t up;
+    uplink_get_stats(&up);
+
+    put_metric(slot, "uptime_ms", to_ms_since_boot(get_absolute_time()));
+    put_metric(slot, "wifi_connect_ms", wifi_connect_ms);
+    put_metric(slot, "wifi_fast_path", wifi_fast_path);
+    put_metric(slot, "samples_total", sample_ring_total());
+
+    sampling_ctl_t smp;
+    sampling_ctl_get(&smp);
+    put_metric(slot, "sampling_period_ms", smp.period_ms);
+    put_metric(slot, "sampling_batch_size", smp.batch_size);
+    put_metric(slot, "sampling_delta", smp.delta);
+    put_metric(slot, "sampling_updates_total", smp.updates);
+    put_metric(slot, "samples_reported_total", smp.reported);
+    put_metric(slot, "samples_suppressed_total", smp.suppressed);
+
+    device_clock_stats_t clk;
+    device_clock_get_stats(&clk);
+    put_metric(slot, "clock_now_us", device_clock_now_us());
+    put_metric(slot, "clock_synced", clk.synced);
+    put_metric(slot, "clock_syncs_total", clk.syncs);
+    put_metric(slot, "clock_steps_total", clk.steps);
+    put_metric_int(slot, "clock_offset_us", clk.last_offset_us);
+    put_metric(slot, "clock_max_abs_offset_us", clk.max_abs_offset_us);
+    put_metric_int(slot, "clock_drift_ppb", clk.drift_ppb);
+    put_metric_int(slot, "clock_rate_ppb", clk.rate_ppb);
+    put_metric(slot, "clock_last_sync_us", clk.last_sync_us);
+    put_metric(slot, "uplink_requests_total", up.requests);
+    put_metric(slot, "uplink_samples_total", up.samples);
+    put_metric(slot, "uplink_bytes_serialized_total", up.bytes_serialized);
+    put_metric(slot, "uplink_pool_exhausted_total", up.pool_exhausted);
+    put_metric(slot, "uplink_in_flight", up.in_flight);
+    put_metric(slot, "uplink_completed_total", up.completed);
+    put_metric(slot, "uplink_failed_total", up.failed);
+    put_metric(slot, "uplink_timed_out_total", up.timed_out);
+    put_metric(slot, "uplink_table_full_total", up.table_full);
+
+    batch_window_stats_t bw;
+    batch_window_get_stats(&bw);
+    put_metric(slot, "uplink_batches_total", bw.pushed);
+    put_metric(slot, "uplink_batches_acked_total", bw.acked);
+    put_metric(slot, "uplink_batch_last_ack", bw.last_ack);
+    put_metric(slot, "uplink_batches_in_window", bw.in_window);
+    put_metric(slot, "uplink_retransmits_total", bw.retransmits);
+    put_metric(slot, "uplink_batches_dropped_total", bw.dropped_batches);
+    put_metric(slot, "uplink_samples_dropped_total", bw.dropped_samples);
+    if (uplink_rate) {
+        taskENTER_CRITICAL();
+        rate_ctl_t rc = *uplink_rate;
+        taskEXIT_CRITICAL();
+        put_metric(slot, "uplink_rate_mrps", rc.rate_mrps);
+        put_metric(slot, "uplink_latency_ewma_ms", rc.latency_ewma_ms);
+        put_metric(slot, "uplink_rate_increases_total", rc.increases);
+        put_metric(slot, "uplink_rate_decreases_total", rc.decreases);
+        put_metric(slot, "uplink_throttled_ms_total", rc.throttled_ms);
+    }
+
+    server_pool_stats_t pool;
+    server_pool_get_stats(&pool);
+    put_metric(slot, "uplink_servers", pool.count);
+    put_metric_int(slot, "uplink_server_current", pool.current);
+    put_metric(slot, "uplink_server_failovers_total", pool.failovers);
+    put_metric(slot, "uplink_server_probes_total", pool.probes);
+    for (int i = 0; i < (int)pool.count; i++) {
+        server_endpoint_t ep;
+        server_pool_get(i, &ep);
+        put_server_metric(slot, "uplink_server_rtt_ms", i, ep.rtt_ewma_ms);
+        put_server_metric(slot, "uplink_server_fail_permille", i, ep.fail_permille);
+        put_server_metric(slot, "uplink_server_requests_total", i, ep.requests);
+        put_server_metric(slot, "uplink_server_down", i, ep.down);
+    }
+
+    radio_window_stats_t radio;
+    radio_window_get_stats(&radio);
+    put_metric(slot, "radio_windows_enabled", radio.enabled);
+    put_metric(slot, "radio_windows_total", radio.windows);
+    put_metric(slot, "radio_active_ms_total", radio.active_ms);
+    put_metric(slot, "radio_duty_permille", radio.duty_permille);
+    put_metric(slot, "radio_pm_errors_total", radio.pm_errors);
+    put_metric(slot, "radio_sample_latency_avg_ms",
+               radio.samples ? radio.latency_sum_ms / radio.samples : 0);
+    put_metric(slot, "radio_sample_latency_max_ms", radio.latency_max_ms);
+
+    display_stats_t disp;
+    display_get_stats(&disp);
+    put_metric(slot, "display_frames_published_total", disp.published);
+    put_metric(slot, "display_frames_flushed_total", disp.flushed);
+    put_metric(slot, "display_frames_coalesced_total", disp.coalesced);
+    put_metric(slot, "display_flushes_empty_total", disp.empty);
+    put_metric(slot, "display_fps_x10", disp.fps_x10);
+    put_metric(slot, "display_flush_us", disp.flush_us_last);
+    put_metric(slot, "display_flush_us_max", disp.flush_us_max);
+    put_metric(slot, "display_i2c_wait_us_max", disp.i2c_wait_us_max);
+    put_metric(slot, "display_bus_bytes_total", disp.bus_bytes);
+
+    cpu_cores_stats_t cpu;
+    cpu_cores_get_stats(&cpu);
+    put_metric(slot, "cpu_cores", cpu.cores);
+    put_metric(slot, "cpu_tasks_pinned_total", cpu.pinned);
+    for (int core = 0; core < (int)cpu.cores && core < 2; core++) {
+        put_core_metric(slot, "cpu_busy_us_total", core, cpu.busy_us[core]);
+        put_core_metric(slot, "cpu_tracked_us_total", core, cpu.tracked_us[core]);
+        put_core_metric(slot, "cpu_busy_permille", core, cpu.busy_permille[core]);
+        put_core_metric(slot, "cpu_window_ms", core, cpu.window_ms[core]);
+    }
+    put_metric(slot, "httpd_requests_total", stats.requests);
+    put_metric(slot, "httpd_busy_total", stats.busy);
+    put_metric(slot, "httpd_requests_per_sec", stats.rps_last);
+    put_metric(slot, "httpd_requests_per_sec_max", stats.rps_max);
+    put_metric(slot, "httpd_metrics_truncated_total", stats.metrics_truncated);
+    finish_metrics(slot);
+}
+
+// ==================== CGI ====================
+static const char *cgi_latest(int index, int num_params, char *param[], char *value[]) {
+    return "/latest.json";
+}
+
+static const char *cgi_history(int index, int num_params, char *param[], char *value[]) {
+    history_n = 1;
+    for (int i = 0; i < num_params; i++) {
+        if (strcmp(param[i], "n") == 0 && value[i]) {
+            uint32_t n = 0;
+            for (const char *p = value[i]; *p >= '0' && *p <= '9' && n <= SAMPLE_RING_SIZE; p++) {
+                n = n * 10 + (uint32_t)(*p - '0');
+            }
+            history_n = n == 0 ? 1 : (n > SAMPLE_RING_SIZE ? SAMPLE_RING_SIZE : n);
+        }
+    }
+    return "/history.json";
+}
+
+static const char *cgi_metrics(int index, int num_params, char *param[], char *value[]) {
+    return "/metrics.txt";
+}
+
+static const tCGI cgi_handlers[] = {
+    { "/latest", cgi_latest },
+    { "/history", cgi_history },
+    { "/metrics", cgi_metrics },
+};
+
+// ==================== Arquivos Customizados (fs.c) ====================
+static void count_request(void) {
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if (now - stats.window_start_ms >= 1000) {
+        stats.rps_last = stats.window_count;
+        if (stats.rps_last > stats.rps_max) {
+            stats.rps_max = stats.rps_last;
+        }
+        stats.window_start_ms = now;
+        stats.window_count = 0;
+    }
+    stats.window_count++;
+    stats.requests++;
+}
+
+int fs_open_custom(struct fs_file *file, const char *name) {
+    void (*render)(httpd_slot_t *) = NULL;
+
+    if (strcmp(name, "/latest.json") == 0) {
+        render = render_latest;
+    } else if (strcmp(name, "/history.json") == 0) {
+        render = render_history;
+    } else if (strcmp(name, "/metrics.txt") == 0) {
+        render = render_metrics;
+    } else {
+        return 0;
+    }
+
+    count_request();
+    for (int i = 0; i < DEVICE_HTTPD_SLOTS; i++) {
+        httpd_slot_t *slot = &slots[i];
+        if (slot->in_use) {
+            continue;
+        }
+        slot->in_use = true;
+        slot->len = 0;
+        slot->truncated = false;
+        render(slot);
+
+        memset(file, 0, sizeof(*file));
+        file->data = slot->data;
+        file->len = (int)slot->len;
+        file->index = (int)slot->len;
+        return 1;
+    }
+    stats.busy++;
+    return 0;
+}
+
+void fs_close_custom(struct fs_file *file) {
+    for (int i = 0; i < DEVICE_HTTPD_SLOTS; i++) {
+        if (file->data == slots[i].data) {
+            slots[i].in_use = false;
+        }
+    }
+}
+
+void device_httpd_set_wifi_stats(uint32_t connect_ms, bool fast_path) {
+    wifi_connect_ms = connect_ms;
+    wifi_fast_path = fast_path;
+}
+
+void device_httpd_set_rate_ctl(const rate_ctl_t *rc) {
+    uplink_rate = rc;
+}
+
+void device_httpd_init(void) {
+    cyw43_arch_lwip_begin();
+    httpd_init();
+    http_set_cgi_handlers(cgi_handlers, sizeof(cgi_handlers) / sizeof(cgi_handlers[0]));
+    cyw43_arch_lwip_end();
+}
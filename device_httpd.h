@@ -0,0 +1,22 @@
+#ifndef DEVICE_HTTPD_H
+#define DEVICE_HTTPD_H
+
+#include "pico/stdlib.h"
+#include "rate_ctl.h"
+
+// Servidor HTTP embarcado (lwIP httpd, porta 80):
+//   /latest      última amostra (JSON)
+//   /history?n=  últimas n amostras (JSON, n <= SAMPLE_RING_SIZE)
+//   /metrics     contadores em texto (WiFi, uplink, httpd)
+#define DEVICE_HTTPD_SLOTS      3       // Respostas simultâneas
+// Cabe o /metrics no pior caso (todos os valores com 20 dígitos,
+// SERVER_POOL_MAX servidores: ~4,1 KB); se faltar, a resposta termina em
+// "metrics_truncated 1" em vez de cortar uma linha no meio
+#define DEVICE_HTTPD_BUF_SIZE   4608
+
+void device_httpd_init(void);
+void device_httpd_set_wifi_stats(uint32_t connect_ms, bool fast_path);
+// Controlador de taxa do uplink exibido em /metrics (lido em seção crítica)
+void device_httpd_set_rate_ctl(const rate_ctl_t *rc);
+
+#endif // DEVICE_HTTPD_H
@@ -0,0 +1,181 @@
+/**
+ * Pipeline do display em task própria, com dois framebuffers
+ *
+ * Os produtores (task de sensores) desenham no canvas de trás e publicam; a
+ * task do display copia só as regiões alteradas para o framebuffer da frente
+ * e faz o envio I2C fora do caminho da amostragem. O canvas de trás fica
+ * travado só durante essa cópia (microssegundos), nunca durante o I2C.
+ * Publicações que chegam enquanto um envio está em curso, ou antes de
+ * DISPLAY_MIN_FRAME_MS, se juntam no envio seguinte (contadas em coalesced).
+ */
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#include "display.h"
+
+static ssd1306_t front;             // Task do display: framebuffer + cópia do painel
+static ssd1306_t back;              // Produtores, sob canvas_lock
+static SemaphoreHandle_t canvas_lock = NULL;
+static SemaphoreHandle_t i2c_lock = NULL;
+static TaskHandle_t display_task_handle = NULL;
+static i2c_inst_t *display_port;
+static uint8_t display_address;
+static uint32_t pending = 0;        // Publicados desde o último envio (canvas_lock)
+static display_stats_t stats;
+
+static uint32_t now_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+#if DISPLAY_TEXT_BENCH_ITERATIONS > 0
+// Texto do layout do firmware pelos dois caminhos do driver, medido no
+// núcleo do display; o framebuffer da frente serve de rascunho e volta limpo
+static void text_bench(void) {
+    static const struct {
+        const char *str;
+        uint8_t scale;
+        int16_t y;
+    } cases[] = {
+        { "1234 mm", 2, 0 },
+        { "1234 mm", 2, 3 },
+        { "Cor: VERMELHO", 1, 24 },
+        { "Sem WiFi", 1, 56 },
+    };
+
+    printf("Display: texto no SSD1306 (%d strings por caso, núcleo %u)\n",
+           DISPLAY_TEXT_BENCH_ITERATIONS, get_core_num());
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        ssd1306_text_bench_t r;
+        ssd1306_bench_text(&front, 0, cases[i].y, cases[i].scale, cases[i].str,
+                           DISPLAY_TEXT_BENCH_ITERATIONS, &r);
+        printf("  %-14s %ux y=%-2d  blit %6.1f us  pixel %7.1f us  (%.1fx)\n",
+               cases[i].str, cases[i].scale, cases[i].y, r.blit_us, r.pixel_us,
+               r.blit_us > 0 ? r.pixel_us / r.blit_us : 0.0f);
+    }
+}
+#endif
+
+static void display_task(void *pvParameters) {
+    xSemaphoreTake(i2c_lock, portMAX_DELAY);
+    ssd1306_init(&front, display_port, display_address);
+    xSemaphoreGive(i2c_lock);
+#if DISPLAY_TEXT_BENCH_ITERATIONS > 0
+    text_bench();
+#endif
+
+    uint32_t last_flush_ms = now_ms() - DISPLAY_MIN_FRAME_MS;
+    uint32_t window_start_ms = now_ms();
+    uint32_t window_flushes = 0;
+
+    while (true) {
+        // O timeout só mantém o fps em dia quando nada é publicado
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+
+        uint32_t now = now_ms();
+        if (now - window_start_ms >= 1000) {
+            taskENTER_CRITICAL();
+            stats.fps_x10 = window_flushes * 10000 / (now - window_start_ms);
+            taskEXIT_CRITICAL();
+            window_start_ms = now;
+            window_flushes = 0;
+            // Esta task roda no núcleo de E/S: fecha a janela de ocupação dele
+            cpu_cores_update();
+        }
+
+        xSemaphoreTake(canvas_lock, portMAX_DELAY);
+        bool has_frame = pending > 0;
+        xSemaphoreGive(canvas_lock);
+        if (!has_frame) {
+            continue;
+        }
+
+        // Limita a taxa de envios: o que for publicado nessa espera vai junto
+        uint32_t since = now - last_flush_ms;
+        if (since < DISPLAY_MIN_FRAME_MS) {
+            vTaskDelay(pdMS_TO_TICKS(DISPLAY_MIN_FRAME_MS - since));
+        }
+
+        xSemaphoreTake(canvas_lock, portMAX_DELAY);
+        ssd1306_copy_dirty(&front, &back);
+        uint32_t frames = pending;
+        pending = 0;
+        xSemaphoreGive(canvas_lock);
+
+        uint64_t t0 = time_us_64();
+        xSemaphoreTake(i2c_lock, portMAX_DELAY);
+        uint64_t t1 = time_us_64();
+        uint32_t bytes = ssd1306_show(&front);
+        xSemaphoreGive(i2c_lock);
+        uint64_t t2 = time_us_64();
+        last_flush_ms = now_ms();
+        window_flushes++;
+
+        uint32_t wait_us = (uint32_t)(t1 - t0);
+        uint32_t flush_us = (uint32_t)(t2 - t1);
+        taskENTER_CRITICAL();
+        stats.flushed++;
+        stats.coalesced += frames - 1;
+        if (bytes == 0) {
+            stats.empty++;
+        }
+        stats.flush_us_last = flush_us;
+        if (flush_us > stats.flush_us_max) {
+            stats.flush_us_max = flush_us;
+        }
+        if (wait_us > stats.i2c_wait_us_max) {
+            stats.i2c_wait_us_max = wait_us;
+        }
+        stats.bus_bytes = front.stats.bus_bytes;
+        taskEXIT_CRITICAL();
+    }
+}
+
+bool display_init(i2c_inst_t *i2c_port, uint8_t address, SemaphoreHandle_t i2c_mutex) {
+    if (display_task_handle) {
+        return true;
+    }
+    canvas_lock = xSemaphoreCreateMutex();
+    if (!canvas_lock) {
+        return false;
+    }
+    i2c_lock = i2c_mutex;
+    display_port = i2c_port;
+    display_address = address;
+    ssd1306_canvas_init(&back);
+    stats = (display_stats_t){ 0 };
+
+    if (cpu_cores_create_task(display_task, "Display", DISPLAY_TASK_STACK, NULL,
+                              DISPLAY_TASK_PRIORITY, DISPLAY_TASK_CORE,
+                              &display_task_handle) != pdPASS) {
+        display_task_handle = NULL;
+        return false;
+    }
+    return true;
+}
+
+ssd1306_t *display_begin(void) {
+    if (!display_task_handle) {
+        return NULL;
+    }
+    xSemaphoreTake(canvas_lock, portMAX_DELAY);
+    return &back;
+}
+
+void display_publish(void) {
+    pending++;
+    xSemaphoreGive(canvas_lock);
+    taskENTER_CRITICAL();
+    stats.published++;
+    taskEXIT_CRITICAL();
+    xTaskNotifyGive(display_task_handle);
+}
+
+void display_get_stats(display_stats_t *out) {
+    taskENTER_CRITICAL();
+    *out = stats;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,49 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "cpu_cores.h"
+#include "ssd1306.h"
+
+// Intervalo mínimo entre envios ao painel: o que for publicado mais rápido
+// que isso entra junto no envio seguinte
+#define DISPLAY_MIN_FRAME_MS    50
+#define DISPLAY_TASK_PRIORITY   1
+#define DISPLAY_TASK_STACK      1024
+#define DISPLAY_TASK_CORE       CPU_CORE_IO     // Junto da task de sensores
+// Strings por caso do ssd1306_bench_text() na partida da task (printf no
+// serial, antes do primeiro envio); 0 desliga. Vem do CMake
+// (-DDISPLAY_TEXT_BENCH_ITERATIONS=100)
+#ifndef DISPLAY_TEXT_BENCH_ITERATIONS
+#define DISPLAY_TEXT_BENCH_ITERATIONS 0
+#endif
+
+typedef struct {
+	uint32_t published;         // display_publish()
+	uint32_t flushed;           // Envios ao painel
+	uint32_t coalesced;         // Publicados que nunca foram exibidos sozinhos
+	uint32_t empty;             // Envios em que nada mudou no painel
+	uint32_t fps_x10;           // Envios/s no último segundo completo (x10)
+	uint32_t flush_us_last;     // Transferência I2C do último envio
+	uint32_t flush_us_max;
+	uint32_t i2c_wait_us_max;   // Espera pelo mutex do I2C0
+	uint64_t bus_bytes;         // Bytes no I2C (ssd1306_stats_t)
+} display_stats_t;
+
+// Cria a task do display. i2c_mutex protege o barramento dividido com outros
+// dispositivos (TCS34725 no I2C0); o I2C já deve estar configurado
+bool display_init(i2c_inst_t *i2c_port, uint8_t address, SemaphoreHandle_t i2c_mutex);
+
+// Canvas de trás para desenhar, travado até display_publish(); NULL se o
+// display não foi iniciado. O conteúdo fica entre quadros, então basta
+// redesenhar o que mudou
+ssd1306_t *display_begin(void);
+// Libera o canvas e acorda a task do display; não espera o I2C
+void display_publish(void);
+
+void display_get_stats(display_stats_t *out);
+
+#endif // DISPLAY_H
@@ -0,0 +1,207 @@
+#ifndef FONT_SCALED_H
+#define FONT_SCALED_H
+
+// Gerado por gen_font_scaled.py a partir do font.h; não editar à mão.
+// font_5x7_xN[c][col][page]: coluna col do glifo c esticada N vezes na
+// vertical, em N bytes de página (bit 0 = linha de cima)
+
+#include <stdint.h>
+#include "font.h"
+
+static const uint8_t font_5x7_x2[FONT_LAST_CHAR - FONT_FIRST_CHAR + 1][FONT_WIDTH][2] = {
+	{{0x00, 0x00}, {0x00, 0x00}, {0x00, 0x00}, {0x00, 0x00}, {0x00, 0x00}}, // ' '
+	{{0x00, 0x00}, {0x00, 0x00}, {0xFF, 0x33}, {0x00, 0x00}, {0x00, 0x00}}, // '!'
+	{{0x00, 0x00}, {0x3F, 0x00}, {0x00, 0x00}, {0x3F, 0x00}, {0x00, 0x00}}, // '"'
+	{{0x30, 0x03}, {0xFF, 0x3F}, {0x30, 0x03}, {0xFF, 0x3F}, {0x30, 0x03}}, // '#'
+	{{0x30, 0x0C}, {0xCC, 0x0C}, {0xFF, 0x3F}, {0xCC, 0x0C}, {0x0C, 0x03}}, // '$'
+	{{0x0F, 0x0C}, {0x0F, 0x03}, {0xC0, 0x00}, {0x30, 0x3C}, {0x0C, 0x3C}}, // '%'
+	{{0x3C, 0x0F}, {0xC3, 0x30}, {0x33, 0x33}, {0x0C, 0x0C}, {0x00, 0x33}}, // '&'
+	{{0x00, 0x00}, {0x33, 0x00}, {0x0F, 0x00}, {0x00, 0x00}, {0x00, 0x00}}, // '''
+	{{0x00, 0x00}, {0xF0, 0x03}, {0x0C, 0x0C}, {0x03, 0x30}, {0x00, 0x00}}, // '('
+	{{0x00, 0x00}, {0x03, 0x30}, {0x0C, 0x0C}, {0xF0, 0x03}, {0x00, 0x00}}, // ')'
+	{{0xC0, 0x00}, {0xCC, 0x0C}, {0xF0, 0x03}, {0xCC, 0x0C}, {0xC0, 0x00}}, // '*'
+	{{0xC0, 0x00}, {0xC0, 0x00}, {0xFC, 0x0F}, {0xC0, 0x00}, {0xC0, 0x00}}, // '+'
+	{{0x00, 0x00}, {0x00, 0x33}, {0x00, 0x0F}, {0x00, 0x00}, {0x00, 0x00}}, // ','
+	{{0xC0, 0x00}, {0xC0, 0x00}, {0xC0, 0x00}, {0xC0, 0x00}, {0xC0, 0x00}}, // '-'
+	{{0x00, 0x00}, {0x00, 0x3C}, {0x00, 0x3C}, {0x00, 0x00}, {0x00, 0x00}}, // '.'
+	{{0x00, 0x0C}, {0x00, 0x03}, {0xC0, 0x00}, {0x30, 0x00}, {0x0C, 0x00}}, // '/'
+	{{0xFC, 0x0F}, {0x03, 0x33}, {0xC3, 0x30}, {0x33, 0x30}, {0xFC, 0x0F}}, // '0'
+	{{0x00, 0x00}, {0x0C, 0x30}, {0xFF, 0x3F}, {0x00, 0x30}, {0x00, 0x00}}, // '1'
+	{{0x0C, 0x30}, {0x03, 0x3C}, {0x03, 0x33}, {0xC3, 0x30}, {0x3C, 0x30}}, // '2'
+	{{0x03, 0x0C}, {0x03, 0x30}, {0x33, 0x30}, {0xCF, 0x30}, {0x03, 0x0F}}, // '3'
+	{{0xC0, 0x03}, {0x30, 0x03}, {0x0C, 0x03}, {0xFF, 0x3F}, {0x00, 0x03}}, // '4'
+	{{0x3F, 0x0C}, {0x33, 0x30}, {0x33, 0x30}, {0x33, 0x30}, {0xC3, 0x0F}}, // '5'
+	{{0xF0, 0x0F}, {0xCC, 0x30}, {0xC3, 0x30}, {0xC3, 0x30}, {0x00, 0x0F}}, // '6'
+	{{0x03, 0x00}, {0x03, 0x3F}, {0xC3, 0x00}, {0x33, 0x00}, {0x0F, 0x00}}, // '7'
+	{{0x3C, 0x0F}, {0xC3, 0x30}, {0xC3, 0x30}, {0xC3, 0x30}, {0x3C, 0x0F}}, // '8'
+	{{0x3C, 0x00}, {0xC3, 0x30}, {0xC3, 0x30}, {0xC3, 0x0C}, {0xFC, 0x03}}, // '9'
+	{{0x00, 0x00}, {0x3C, 0x0F}, {0x3C, 0x0F}, {0x00, 0x00}, {0x00, 0x00}}, // ':'
+	{{0x00, 0x00}, {0x3C, 0x33}, {0x3C, 0x0F}, {0x00, 0x00}, {0x00, 0x00}}, // ';'
+	{{0xC0, 0x00}, {0x30, 0x03}, {0x0C, 0x0C}, {0x03, 0x30}, {0x00, 0x00}}, // '<'
+	{{0x30, 0x03}, {0x30, 0x03}, {0x30, 0x03}, {0x30, 0x03}, {0x30, 0x03}}, // '='
+	{{0x00, 0x00}, {0x03, 0x30}, {0x0C, 0x0C}, {0x30, 0x03}, {0xC0, 0x00}}, // '>'
+	{{0x0C, 0x00}, {0x03, 0x00}, {0x03, 0x33}, {0xC3, 0x00}, {0x3C, 0x00}}, // '?'
+	{{0x0C, 0x0F}, {0xC3, 0x30}, {0xC3, 0x3F}, {0x03, 0x30}, {0xFC, 0x0F}}, // '@'
+	{{0xFC, 0x3F}, {0x03, 0x03}, {0x03, 0x03}, {0x03, 0x03}, {0xFC, 0x3F}}, // 'A'
+	{{0xFF, 0x3F}, {0xC3, 0x30}, {0xC3, 0x30}, {0xC3, 0x30}, {0x3C, 0x0F}}, // 'B'
+	{{0xFC, 0x0F}, {0x03, 0x30}, {0x03, 0x30}, {0x03, 0x30}, {0x0C, 0x0C}}, // 'C'
+	{{0xFF, 0x3F}, {0x03, 0x30}, {0x03, 0x30}, {0x0C, 0x0C}, {0xF0, 0x03}}, // 'D'
+	{{0xFF, 0x3F}, {0xC3, 0x30}, {0xC3, 0x30}, {0xC3, 0x30}, {0x03, 0x30}}, // 'E'
+	{{0xFF, 0x3F}, {0xC3, 0x00}, {0xC3, 0x00}, {0xC3, 0x00}, {0x03, 0x00}}, // 'F'
+	{{0xFC, 0x0F}, {0x03, 0x30}, {0xC3, 0x30}, {0xC3, 0x30}, {0xCC, 0x3F}}, // 'G'
+	{{0xFF, 0x3F}, {0xC0, 0x00}, {0xC0, 0x00}, {0xC0, 0x00}, {0xFF, 0x3F}}, // 'H'
+	{{0x00, 0x00}, {0x03, 0x30}, {0xFF, 0x3F}, {0x03, 0x30}, {0x00, 0x00}}, // 'I'
+	{{0x00, 0x0C}, {0x00, 0x30}, {0x03, 0x30}, {0xFF, 0x0F}, {0x03, 0x00}}, // 'J'
+	{{0xFF, 0x3F}, {0xC0, 0x00}, {0x30, 0x03}, {0x0C, 0x0C}, {0x03, 0x30}}, // 'K'
+	{{0xFF, 0x3F}, {0x00, 0x30}, {0x00, 0x30}, {0x00, 0x30}, {0x00, 0x30}}, // 'L'
+	{{0xFF, 0x3F}, {0x0C, 0x00}, {0xF0, 0x00}, {0x0C, 0x00}, {0xFF, 0x3F}}, // 'M'
+	{{0xFF, 0x3F}, {0x30, 0x00}, {0xC0, 0x00}, {0x00, 0x03}, {0xFF, 0x3F}}, // 'N'
+	{{0xFC, 0x0F}, {0x03, 0x30}, {0x03, 0x30}, {0x03, 0x30}, {0xFC, 0x0F}}, // 'O'
+	{{0xFF, 0x3F}, {0xC3, 0x00}, {0xC3, 0x00}, {0xC3, 0x00}, {0x3C, 0x00}}, // 'P'
+	{{0xFC, 0x0F}, {0x03, 0x30}, {0x03, 0x33}, {0x03, 0x0C}, {0xFC, 0x33}}, // 'Q'
+	{{0xFF, 0x3F}, {0xC3, 0x00}, {0xC3, 0x03}, {0xC3, 0x0C}, {0x3C, 0x30}}, // 'R'
+	{{0x3C, 0x30}, {0xC3, 0x30}, {0xC3, 0x30}, {0xC3, 0x30}, {0x03, 0x0F}}, // 'S'
+	{{0x03, 0x00}, {0x03, 0x00}, {0xFF, 0x3F}, {0x03, 0x00}, {0x03, 0x00}}, // 'T'
+	{{0xFF, 0x0F}, {0x00, 0x30}, {0x00, 0x30}, {0x00, 0x30}, {0xFF, 0x0F}}, // 'U'
+	{{0xFF, 0x03}, {0x00, 0x0C}, {0x00, 0x30}, {0x00, 0x0C}, {0xFF, 0x03}}, // 'V'
+	{{0xFF, 0x0F}, {0x00, 0x30}, {0xC0, 0x0F}, {0x00, 0x30}, {0xFF, 0x0F}}, // 'W'
+	{{0x0F, 0x3C}, {0x30, 0x03}, {0xC0, 0x00}, {0x30, 0x03}, {0x0F, 0x3C}}, // 'X'
+	{{0x3F, 0x00}, {0xC0, 0x00}, {0x00, 0x3F}, {0xC0, 0x00}, {0x3F, 0x00}}, // 'Y'
+	{{0x03, 0x3C}, {0x03, 0x33}, {0xC3, 0x30}, {0x33, 0x30}, {0x0F, 0x30}}, // 'Z'
+	{{0x00, 0x00}, {0xFF, 0x3F}, {0x03, 0x30}, {0x03, 0x30}, {0x00, 0x00}}, // '['
+	{{0x0C, 0x00}, {0x30, 0x00}, {0xC0, 0x00}, {0x00, 0x03}, {0x00, 0x0C}}, // '\'
+	{{0x00, 0x00}, {0x03, 0x30}, {0x03, 0x30}, {0xFF, 0x3F}, {0x00, 0x00}}, // ']'
+	{{0x30, 0x00}, {0x0C, 0x00}, {0x03, 0x00}, {0x0C, 0x00}, {0x30, 0x00}}, // '^'
+	{{0x00, 0x30}, {0x00, 0x30}, {0x00, 0x30}, {0x00, 0x30}, {0x00, 0x30}}, // '_'
+	{{0x00, 0x00}, {0x03, 0x00}, {0x0C, 0x00}, {0x30, 0x00}, {0x00, 0x00}}, // '`'
+	{{0x00, 0x0C}, {0x30, 0x33}, {0x30, 0x33}, {0x30, 0x33}, {0xC0, 0x3F}}, // 'a'
+	{{0xFF, 0x3F}, {0xC0, 0x30}, {0x30, 0x30}, {0x30, 0x30}, {0xC0, 0x0F}}, // 'b'
+	{{0xC0, 0x0F}, {0x30, 0x30}, {0x30, 0x30}, {0x30, 0x30}, {0x00, 0x0C}}, // 'c'
+	{{0xC0, 0x0F}, {0x30, 0x30}, {0x30, 0x30}, {0xC0, 0x30}, {0xFF, 0x3F}}, // 'd'
+	{{0xC0, 0x0F}, {0x30, 0x33}, {0x30, 0x33}, {0x30, 0x33}, {0xC0, 0x03}}, // 'e'
+	{{0xC0, 0x00}, {0xFC, 0x3F}, {0xC3, 0x00}, {0x03, 0x00}, {0x0C, 0x00}}, // 'f'
+	{{0xF0, 0x00}, {0x0C, 0x33}, {0x0C, 0x33}, {0x0C, 0x33}, {0xFC, 0x0F}}, // 'g'
+	{{0xFF, 0x3F}, {0xC0, 0x00}, {0x30, 0x00}, {0x30, 0x00}, {0xC0, 0x3F}}, // 'h'
+	{{0x00, 0x00}, {0x30, 0x30}, {0xF3, 0x3F}, {0x00, 0x30}, {0x00, 0x00}}, // 'i'
+	{{0x00, 0x0C}, {0x00, 0x30}, {0x30, 0x30}, {0xF3, 0x0F}, {0x00, 0x00}}, // 'j'
+	{{0xFF, 0x3F}, {0x00, 0x03}, {0xC0, 0x0C}, {0x30, 0x30}, {0x00, 0x00}}, // 'k'
+	{{0x00, 0x00}, {0x03, 0x30}, {0xFF, 0x3F}, {0x00, 0x30}, {0x00, 0x00}}, // 'l'
+	{{0xF0, 0x3F}, {0x30, 0x00}, {0xC0, 0x03}, {0x30, 0x00}, {0xC0, 0x3F}}, // 'm'
+	{{0xF0, 0x3F}, {0xC0, 0x00}, {0x30, 0x00}, {0x30, 0x00}, {0xC0, 0x3F}}, // 'n'
+	{{0xC0, 0x0F}, {0x30, 0x30}, {0x30, 0x30}, {0x30, 0x30}, {0xC0, 0x0F}}, // 'o'
+	{{0xF0, 0x3F}, {0x30, 0x03}, {0x30, 0x03}, {0x30, 0x03}, {0xC0, 0x00}}, // 'p'
+	{{0xC0, 0x00}, {0x30, 0x03}, {0x30, 0x03}, {0xC0, 0x03}, {0xF0, 0x3F}}, // 'q'
+	{{0xF0, 0x3F}, {0xC0, 0x00}, {0x30, 0x00}, {0x30, 0x00}, {0xC0, 0x00}}, // 'r'
+	{{0xC0, 0x30}, {0x30, 0x33}, {0x30, 0x33}, {0x30, 0x33}, {0x00, 0x0C}}, // 's'
+	{{0x30, 0x00}, {0xFF, 0x0F}, {0x30, 0x30}, {0x00, 0x30}, {0x00, 0x0C}}, // 't'
+	{{0xF0, 0x0F}, {0x00, 0x30}, {0x00, 0x30}, {0x00, 0x0C}, {0xF0, 0x3F}}, // 'u'
+	{{0xF0, 0x03}, {0x00, 0x0C}, {0x00, 0x30}, {0x00, 0x0C}, {0xF0, 0x03}}, // 'v'
+	{{0xF0, 0x0F}, {0x00, 0x30}, {0x00, 0x0F}, {0x00, 0x30}, {0xF0, 0x0F}}, // 'w'
+	{{0x30, 0x30}, {0xC0, 0x0C}, {0x00, 0x03}, {0xC0, 0x0C}, {0x30, 0x30}}, // 'x'
+	{{0xF0, 0x00}, {0x00, 0x33}, {0x00, 0x33}, {0x00, 0x33}, {0xF0, 0x0F}}, // 'y'
+	{{0x30, 0x30}, {0x30, 0x3C}, {0x30, 0x33}, {0xF0, 0x30}, {0x30, 0x30}}, // 'z'
+	{{0x00, 0x00}, {0xC0, 0x00}, {0x3C, 0x0F}, {0x03, 0x30}, {0x00, 0x00}}, // '{'
+	{{0x00, 0x00}, {0x00, 0x00}, {0xFF, 0x3F}, {0x00, 0x00}, {0x00, 0x00}}, // '|'
+	{{0x00, 0x00}, {0x03, 0x30}, {0x3C, 0x0F}, {0xC0, 0x00}, {0x00, 0x00}}, // '}'
+	{{0xC0, 0x00}, {0x30, 0x00}, {0xC0, 0x00}, {0x00, 0x03}, {0xC0, 0x00}}, // '~'
+};
+
+static const uint8_t font_5x7_x3[FONT_LAST_CHAR - FONT_FIRST_CHAR + 1][FONT_WIDTH][3] = {
+	{{0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}}, // ' '
+	{{0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}, {0xFF, 0x7F, 0x1C}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}}, // '!'
+	{{0x00, 0x00, 0x00}, {0xFF, 0x01, 0x00}, {0x00, 0x00, 0x00}, {0xFF, 0x01, 0x00}, {0x00, 0x00, 0x00}}, // '"'
+	{{0xC0, 0x71, 0x00}, {0xFF, 0xFF, 0x1F}, {0xC0, 0x71, 0x00}, {0xFF, 0xFF, 0x1F}, {0xC0, 0x71, 0x00}}, // '#'
+	{{0xC0, 0x81, 0x03}, {0x38, 0x8E, 0x03}, {0xFF, 0xFF, 0x1F}, {0x38, 0x8E, 0x03}, {0x38, 0x70, 0x00}}, // '$'
+	{{0x3F, 0x80, 0x03}, {0x3F, 0x70, 0x00}, {0x00, 0x0E, 0x00}, {0xC0, 0x81, 0x1F}, {0x38, 0x80, 0x1F}}, // '%'
+	{{0xF8, 0xF1, 0x03}, {0x07, 0x0E, 0x1C}, {0xC7, 0x71, 0x1C}, {0x38, 0x80, 0x03}, {0x00, 0x70, 0x1C}}, // '&'
+	{{0x00, 0x00, 0x00}, {0xC7, 0x01, 0x00}, {0x3F, 0x00, 0x00}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}}, // '''
+	{{0x00, 0x00, 0x00}, {0xC0, 0x7F, 0x00}, {0x38, 0x80, 0x03}, {0x07, 0x00, 0x1C}, {0x00, 0x00, 0x00}}, // '('
+	{{0x00, 0x00, 0x00}, {0x07, 0x00, 0x1C}, {0x38, 0x80, 0x03}, {0xC0, 0x7F, 0x00}, {0x00, 0x00, 0x00}}, // ')'
+	{{0x00, 0x0E, 0x00}, {0x38, 0x8E, 0x03}, {0xC0, 0x7F, 0x00}, {0x38, 0x8E, 0x03}, {0x00, 0x0E, 0x00}}, // '*'
+	{{0x00, 0x0E, 0x00}, {0x00, 0x0E, 0x00}, {0xF8, 0xFF, 0x03}, {0x00, 0x0E, 0x00}, {0x00, 0x0E, 0x00}}, // '+'
+	{{0x00, 0x00, 0x00}, {0x00, 0x70, 0x1C}, {0x00, 0xF0, 0x03}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}}, // ','
+	{{0x00, 0x0E, 0x00}, {0x00, 0x0E, 0x00}, {0x00, 0x0E, 0x00}, {0x00, 0x0E, 0x00}, {0x00, 0x0E, 0x00}}, // '-'
+	{{0x00, 0x00, 0x00}, {0x00, 0x80, 0x1F}, {0x00, 0x80, 0x1F}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}}, // '.'
+	{{0x00, 0x80, 0x03}, {0x00, 0x70, 0x00}, {0x00, 0x0E, 0x00}, {0xC0, 0x01, 0x00}, {0x38, 0x00, 0x00}}, // '/'
+	{{0xF8, 0xFF, 0x03}, {0x07, 0x70, 0x1C}, {0x07, 0x0E, 0x1C}, {0xC7, 0x01, 0x1C}, {0xF8, 0xFF, 0x03}}, // '0'
+	{{0x00, 0x00, 0x00}, {0x38, 0x00, 0x1C}, {0xFF, 0xFF, 0x1F}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x00}}, // '1'
+	{{0x38, 0x00, 0x1C}, {0x07, 0x80, 0x1F}, {0x07, 0x70, 0x1C}, {0x07, 0x0E, 0x1C}, {0xF8, 0x01, 0x1C}}, // '2'
+	{{0x07, 0x80, 0x03}, {0x07, 0x00, 0x1C}, {0xC7, 0x01, 0x1C}, {0x3F, 0x0E, 0x1C}, {0x07, 0xF0, 0x03}}, // '3'
+	{{0x00, 0x7E, 0x00}, {0xC0, 0x71, 0x00}, {0x38, 0x70, 0x00}, {0xFF, 0xFF, 0x1F}, {0x00, 0x70, 0x00}}, // '4'
+	{{0xFF, 0x81, 0x03}, {0xC7, 0x01, 0x1C}, {0xC7, 0x01, 0x1C}, {0xC7, 0x01, 0x1C}, {0x07, 0xFE, 0x03}}, // '5'
+	{{0xC0, 0xFF, 0x03}, {0x38, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0x00, 0xF0, 0x03}}, // '6'
+	{{0x07, 0x00, 0x00}, {0x07, 0xF0, 0x1F}, {0x07, 0x0E, 0x00}, {0xC7, 0x01, 0x00}, {0x3F, 0x00, 0x00}}, // '7'
+	{{0xF8, 0xF1, 0x03}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0xF8, 0xF1, 0x03}}, // '8'
+	{{0xF8, 0x01, 0x00}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0x07, 0x8E, 0x03}, {0xF8, 0x7F, 0x00}}, // '9'
+	{{0x00, 0x00, 0x00}, {0xF8, 0xF1, 0x03}, {0xF8, 0xF1, 0x03}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}}, // ':'
+	{{0x00, 0x00, 0x00}, {0xF8, 0x71, 0x1C}, {0xF8, 0xF1, 0x03}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}}, // ';'
+	{{0x00, 0x0E, 0x00}, {0xC0, 0x71, 0x00}, {0x38, 0x80, 0x03}, {0x07, 0x00, 0x1C}, {0x00, 0x00, 0x00}}, // '<'
+	{{0xC0, 0x71, 0x00}, {0xC0, 0x71, 0x00}, {0xC0, 0x71, 0x00}, {0xC0, 0x71, 0x00}, {0xC0, 0x71, 0x00}}, // '='
+	{{0x00, 0x00, 0x00}, {0x07, 0x00, 0x1C}, {0x38, 0x80, 0x03}, {0xC0, 0x71, 0x00}, {0x00, 0x0E, 0x00}}, // '>'
+	{{0x38, 0x00, 0x00}, {0x07, 0x00, 0x00}, {0x07, 0x70, 0x1C}, {0x07, 0x0E, 0x00}, {0xF8, 0x01, 0x00}}, // '?'
+	{{0x38, 0xF0, 0x03}, {0x07, 0x0E, 0x1C}, {0x07, 0xFE, 0x1F}, {0x07, 0x00, 0x1C}, {0xF8, 0xFF, 0x03}}, // '@'
+	{{0xF8, 0xFF, 0x1F}, {0x07, 0x70, 0x00}, {0x07, 0x70, 0x00}, {0x07, 0x70, 0x00}, {0xF8, 0xFF, 0x1F}}, // 'A'
+	{{0xFF, 0xFF, 0x1F}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0xF8, 0xF1, 0x03}}, // 'B'
+	{{0xF8, 0xFF, 0x03}, {0x07, 0x00, 0x1C}, {0x07, 0x00, 0x1C}, {0x07, 0x00, 0x1C}, {0x38, 0x80, 0x03}}, // 'C'
+	{{0xFF, 0xFF, 0x1F}, {0x07, 0x00, 0x1C}, {0x07, 0x00, 0x1C}, {0x38, 0x80, 0x03}, {0xC0, 0x7F, 0x00}}, // 'D'
+	{{0xFF, 0xFF, 0x1F}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0x07, 0x00, 0x1C}}, // 'E'
+	{{0xFF, 0xFF, 0x1F}, {0x07, 0x0E, 0x00}, {0x07, 0x0E, 0x00}, {0x07, 0x0E, 0x00}, {0x07, 0x00, 0x00}}, // 'F'
+	{{0xF8, 0xFF, 0x03}, {0x07, 0x00, 0x1C}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0x38, 0xFE, 0x1F}}, // 'G'
+	{{0xFF, 0xFF, 0x1F}, {0x00, 0x0E, 0x00}, {0x00, 0x0E, 0x00}, {0x00, 0x0E, 0x00}, {0xFF, 0xFF, 0x1F}}, // 'H'
+	{{0x00, 0x00, 0x00}, {0x07, 0x00, 0x1C}, {0xFF, 0xFF, 0x1F}, {0x07, 0x00, 0x1C}, {0x00, 0x00, 0x00}}, // 'I'
+	{{0x00, 0x80, 0x03}, {0x00, 0x00, 0x1C}, {0x07, 0x00, 0x1C}, {0xFF, 0xFF, 0x03}, {0x07, 0x00, 0x00}}, // 'J'
+	{{0xFF, 0xFF, 0x1F}, {0x00, 0x0E, 0x00}, {0xC0, 0x71, 0x00}, {0x38, 0x80, 0x03}, {0x07, 0x00, 0x1C}}, // 'K'
+	{{0xFF, 0xFF, 0x1F}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x1C}}, // 'L'
+	{{0xFF, 0xFF, 0x1F}, {0x38, 0x00, 0x00}, {0xC0, 0x0F, 0x00}, {0x38, 0x00, 0x00}, {0xFF, 0xFF, 0x1F}}, // 'M'
+	{{0xFF, 0xFF, 0x1F}, {0xC0, 0x01, 0x00}, {0x00, 0x0E, 0x00}, {0x00, 0x70, 0x00}, {0xFF, 0xFF, 0x1F}}, // 'N'
+	{{0xF8, 0xFF, 0x03}, {0x07, 0x00, 0x1C}, {0x07, 0x00, 0x1C}, {0x07, 0x00, 0x1C}, {0xF8, 0xFF, 0x03}}, // 'O'
+	{{0xFF, 0xFF, 0x1F}, {0x07, 0x0E, 0x00}, {0x07, 0x0E, 0x00}, {0x07, 0x0E, 0x00}, {0xF8, 0x01, 0x00}}, // 'P'
+	{{0xF8, 0xFF, 0x03}, {0x07, 0x00, 0x1C}, {0x07, 0x70, 0x1C}, {0x07, 0x80, 0x03}, {0xF8, 0x7F, 0x1C}}, // 'Q'
+	{{0xFF, 0xFF, 0x1F}, {0x07, 0x0E, 0x00}, {0x07, 0x7E, 0x00}, {0x07, 0x8E, 0x03}, {0xF8, 0x01, 0x1C}}, // 'R'
+	{{0xF8, 0x01, 0x1C}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0x07, 0x0E, 0x1C}, {0x07, 0xF0, 0x03}}, // 'S'
+	{{0x07, 0x00, 0x00}, {0x07, 0x00, 0x00}, {0xFF, 0xFF, 0x1F}, {0x07, 0x00, 0x00}, {0x07, 0x00, 0x00}}, // 'T'
+	{{0xFF, 0xFF, 0x03}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x1C}, {0xFF, 0xFF, 0x03}}, // 'U'
+	{{0xFF, 0x7F, 0x00}, {0x00, 0x80, 0x03}, {0x00, 0x00, 0x1C}, {0x00, 0x80, 0x03}, {0xFF, 0x7F, 0x00}}, // 'V'
+	{{0xFF, 0xFF, 0x03}, {0x00, 0x00, 0x1C}, {0x00, 0xFE, 0x03}, {0x00, 0x00, 0x1C}, {0xFF, 0xFF, 0x03}}, // 'W'
+	{{0x3F, 0x80, 0x1F}, {0xC0, 0x71, 0x00}, {0x00, 0x0E, 0x00}, {0xC0, 0x71, 0x00}, {0x3F, 0x80, 0x1F}}, // 'X'
+	{{0xFF, 0x01, 0x00}, {0x00, 0x0E, 0x00}, {0x00, 0xF0, 0x1F}, {0x00, 0x0E, 0x00}, {0xFF, 0x01, 0x00}}, // 'Y'
+	{{0x07, 0x80, 0x1F}, {0x07, 0x70, 0x1C}, {0x07, 0x0E, 0x1C}, {0xC7, 0x01, 0x1C}, {0x3F, 0x00, 0x1C}}, // 'Z'
+	{{0x00, 0x00, 0x00}, {0xFF, 0xFF, 0x1F}, {0x07, 0x00, 0x1C}, {0x07, 0x00, 0x1C}, {0x00, 0x00, 0x00}}, // '['
+	{{0x38, 0x00, 0x00}, {0xC0, 0x01, 0x00}, {0x00, 0x0E, 0x00}, {0x00, 0x70, 0x00}, {0x00, 0x80, 0x03}}, // '\'
+	{{0x00, 0x00, 0x00}, {0x07, 0x00, 0x1C}, {0x07, 0x00, 0x1C}, {0xFF, 0xFF, 0x1F}, {0x00, 0x00, 0x00}}, // ']'
+	{{0xC0, 0x01, 0x00}, {0x38, 0x00, 0x00}, {0x07, 0x00, 0x00}, {0x38, 0x00, 0x00}, {0xC0, 0x01, 0x00}}, // '^'
+	{{0x00, 0x00, 0x1C}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x1C}}, // '_'
+	{{0x00, 0x00, 0x00}, {0x07, 0x00, 0x00}, {0x38, 0x00, 0x00}, {0xC0, 0x01, 0x00}, {0x00, 0x00, 0x00}}, // '`'
+	{{0x00, 0x80, 0x03}, {0xC0, 0x71, 0x1C}, {0xC0, 0x71, 0x1C}, {0xC0, 0x71, 0x1C}, {0x00, 0xFE, 0x1F}}, // 'a'
+	{{0xFF, 0xFF, 0x1F}, {0x00, 0x0E, 0x1C}, {0xC0, 0x01, 0x1C}, {0xC0, 0x01, 0x1C}, {0x00, 0xFE, 0x03}}, // 'b'
+	{{0x00, 0xFE, 0x03}, {0xC0, 0x01, 0x1C}, {0xC0, 0x01, 0x1C}, {0xC0, 0x01, 0x1C}, {0x00, 0x80, 0x03}}, // 'c'
+	{{0x00, 0xFE, 0x03}, {0xC0, 0x01, 0x1C}, {0xC0, 0x01, 0x1C}, {0x00, 0x0E, 0x1C}, {0xFF, 0xFF, 0x1F}}, // 'd'
+	{{0x00, 0xFE, 0x03}, {0xC0, 0x71, 0x1C}, {0xC0, 0x71, 0x1C}, {0xC0, 0x71, 0x1C}, {0x00, 0x7E, 0x00}}, // 'e'
+	{{0x00, 0x0E, 0x00}, {0xF8, 0xFF, 0x1F}, {0x07, 0x0E, 0x00}, {0x07, 0x00, 0x00}, {0x38, 0x00, 0x00}}, // 'f'
+	{{0xC0, 0x0F, 0x00}, {0x38, 0x70, 0x1C}, {0x38, 0x70, 0x1C}, {0x38, 0x70, 0x1C}, {0xF8, 0xFF, 0x03}}, // 'g'
+	{{0xFF, 0xFF, 0x1F}, {0x00, 0x0E, 0x00}, {0xC0, 0x01, 0x00}, {0xC0, 0x01, 0x00}, {0x00, 0xFE, 0x1F}}, // 'h'
+	{{0x00, 0x00, 0x00}, {0xC0, 0x01, 0x1C}, {0xC7, 0xFF, 0x1F}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x00}}, // 'i'
+	{{0x00, 0x80, 0x03}, {0x00, 0x00, 0x1C}, {0xC0, 0x01, 0x1C}, {0xC7, 0xFF, 0x03}, {0x00, 0x00, 0x00}}, // 'j'
+	{{0xFF, 0xFF, 0x1F}, {0x00, 0x70, 0x00}, {0x00, 0x8E, 0x03}, {0xC0, 0x01, 0x1C}, {0x00, 0x00, 0x00}}, // 'k'
+	{{0x00, 0x00, 0x00}, {0x07, 0x00, 0x1C}, {0xFF, 0xFF, 0x1F}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x00}}, // 'l'
+	{{0xC0, 0xFF, 0x1F}, {0xC0, 0x01, 0x00}, {0x00, 0x7E, 0x00}, {0xC0, 0x01, 0x00}, {0x00, 0xFE, 0x1F}}, // 'm'
+	{{0xC0, 0xFF, 0x1F}, {0x00, 0x0E, 0x00}, {0xC0, 0x01, 0x00}, {0xC0, 0x01, 0x00}, {0x00, 0xFE, 0x1F}}, // 'n'
+	{{0x00, 0xFE, 0x03}, {0xC0, 0x01, 0x1C}, {0xC0, 0x01, 0x1C}, {0xC0, 0x01, 0x1C}, {0x00, 0xFE, 0x03}}, // 'o'
+	{{0xC0, 0xFF, 0x1F}, {0xC0, 0x71, 0x00}, {0xC0, 0x71, 0x00}, {0xC0, 0x71, 0x00}, {0x00, 0x0E, 0x00}}, // 'p'
+	{{0x00, 0x0E, 0x00}, {0xC0, 0x71, 0x00}, {0xC0, 0x71, 0x00}, {0x00, 0x7E, 0x00}, {0xC0, 0xFF, 0x1F}}, // 'q'
+	{{0xC0, 0xFF, 0x1F}, {0x00, 0x0E, 0x00}, {0xC0, 0x01, 0x00}, {0xC0, 0x01, 0x00}, {0x00, 0x0E, 0x00}}, // 'r'
+	{{0x00, 0x0E, 0x1C}, {0xC0, 0x71, 0x1C}, {0xC0, 0x71, 0x1C}, {0xC0, 0x71, 0x1C}, {0x00, 0x80, 0x03}}, // 's'
+	{{0xC0, 0x01, 0x00}, {0xFF, 0xFF, 0x03}, {0xC0, 0x01, 0x1C}, {0x00, 0x00, 0x1C}, {0x00, 0x80, 0x03}}, // 't'
+	{{0xC0, 0xFF, 0x03}, {0x00, 0x00, 0x1C}, {0x00, 0x00, 0x1C}, {0x00, 0x80, 0x03}, {0xC0, 0xFF, 0x1F}}, // 'u'
+	{{0xC0, 0x7F, 0x00}, {0x00, 0x80, 0x03}, {0x00, 0x00, 0x1C}, {0x00, 0x80, 0x03}, {0xC0, 0x7F, 0x00}}, // 'v'
+	{{0xC0, 0xFF, 0x03}, {0x00, 0x00, 0x1C}, {0x00, 0xF0, 0x03}, {0x00, 0x00, 0x1C}, {0xC0, 0xFF, 0x03}}, // 'w'
+	{{0xC0, 0x01, 0x1C}, {0x00, 0x8E, 0x03}, {0x00, 0x70, 0x00}, {0x00, 0x8E, 0x03}, {0xC0, 0x01, 0x1C}}, // 'x'
+	{{0xC0, 0x0F, 0x00}, {0x00, 0x70, 0x1C}, {0x00, 0x70, 0x1C}, {0x00, 0x70, 0x1C}, {0xC0, 0xFF, 0x03}}, // 'y'
+	{{0xC0, 0x01, 0x1C}, {0xC0, 0x81, 0x1F}, {0xC0, 0x71, 0x1C}, {0xC0, 0x0F, 0x1C}, {0xC0, 0x01, 0x1C}}, // 'z'
+	{{0x00, 0x00, 0x00}, {0x00, 0x0E, 0x00}, {0xF8, 0xF1, 0x03}, {0x07, 0x00, 0x1C}, {0x00, 0x00, 0x00}}, // '{'
+	{{0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}, {0xFF, 0xFF, 0x1F}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}}, // '|'
+	{{0x00, 0x00, 0x00}, {0x07, 0x00, 0x1C}, {0xF8, 0xF1, 0x03}, {0x00, 0x0E, 0x00}, {0x00, 0x00, 0x00}}, // '}'
+	{{0x00, 0x0E, 0x00}, {0xC0, 0x01, 0x00}, {0x00, 0x0E, 0x00}, {0x00, 0x70, 0x00}, {0x00, 0x0E, 0x00}}, // '~'
+};
+
+#endif // FONT_SCALED_H
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""
+Gera font_scaled.h: a fonte 5x7 do font.h esticada na vertical em 2x e 3x
+
+Cada coluna do glifo (8 linhas, bit 0 em cima) vira 16 ou 24 linhas já
+quebradas em bytes de página do SSD1306, então o blitter do ssd1306.c só
+copia bytes; a escala horizontal é repetir a coluna. As tabelas ficam em
+flash (const) e custam 95 x 5 x (2 + 3) = 2375 bytes.
+
+    python3 gen_font_scaled.py            # reescreve font_scaled.h
+    python3 gen_font_scaled.py --check    # sai com 1 se estiver desatualizado
+"""
+
+import argparse
+import os
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+FONT_H = os.path.join(HERE, 'font.h')
+OUT_H = os.path.join(HERE, 'font_scaled.h')
+SCALES = (2, 3)
+
+
+def read_font(path):
+    """Lê as linhas {0x.., ...}, // 'c' do font_5x7 na ordem da tabela"""
+    glyphs = []
+    with open(path) as f:
+        for line in f:
+            m = re.match(r"\s*\{([^}]*)\},\s*//\s*'(.*)'\s*$", line)
+            if m:
+                cols = [int(v, 16) for v in m.group(1).split(',')]
+                glyphs.append((cols, m.group(2)))
+    if len(glyphs) != 0x7E - 0x20 + 1:
+        raise SystemExit(f"{path}: esperava 95 glifos, achei {len(glyphs)}")
+    return glyphs
+
+
+def stretch(column, scale):
+    """Repete cada linha scale vezes; retorna os bytes de página (de cima)"""
+    bits = 0
+    for row in range(8):
+        if column >> row & 1:
+            bits |= ((1 << scale) - 1) << (row * scale)
+    return [(bits >> (8 * page)) & 0xFF for page in range(scale)]
+
+
+def render(glyphs):
+    out = [
+        '#ifndef FONT_SCALED_H',
+        '#define FONT_SCALED_H',
+        '',
+        '// Gerado por gen_font_scaled.py a partir do font.h; não editar à mão.',
+        '// font_5x7_xN[c][col][page]: coluna col do glifo c esticada N vezes na',
+        '// vertical, em N bytes de página (bit 0 = linha de cima)',
+        '',
+        '#include <stdint.h>',
+        '#include "font.h"',
+    ]
+    for scale in SCALES:
+        out += [
+            '',
+            f'static const uint8_t font_5x7_x{scale}'
+            f'[FONT_LAST_CHAR - FONT_FIRST_CHAR + 1][FONT_WIDTH][{scale}] = {{',
+        ]
+        for cols, name in glyphs:
+            cells = ', '.join('{' + ', '.join(f'0x{b:02X}' for b in stretch(c, scale)) + '}'
+                              for c in cols)
+            out.append(f"\t{{{cells}}}, // '{name}'")
+        out.append('};')
+    out += ['', '#endif // FONT_SCALED_H', '']
+    return '\n'.join(out)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Gera as tabelas 2x/3x da fonte do SSD1306")
+    parser.add_argument('--check', action='store_true',
+                        help="só compara com o font_scaled.h atual")
+    args = parser.parse_args()
+
+    text = render(read_font(FONT_H))
+    if args.check:
+        try:
+            with open(OUT_H) as f:
+                current = f.read()
+        except FileNotFoundError:
+            current = None
+        if current != text:
+            print(f"{OUT_H} desatualizado: rode python3 gen_font_scaled.py")
+            sys.exit(1)
+        print(f"{OUT_H} OK")
+    else:
+        with open(OUT_H, 'w') as f:
+            f.write(text)
+        print(f"{OUT_H}: {len(SCALES)} tabelas, escalas {', '.join(map(str, SCALES))}")
@@ -0,0 +1,418 @@
+#!/usr/bin/env python3
+"""
+Gerador de carga: N dispositivos Pico W emulados contra o server.py
+
+Cada dispositivo lê um "sensor" a cada período (com jitter) e envia como o
+firmware: lotes binários v2 em POST /batch com a janela de ACK de
+batch_window.c, ou uma amostra por GET /data (UPLINK_FORMAT_BINARY 0). Uma
+conexão por requisição, com Connection: close. Quedas em rajada tiram parte
+da frota do ar; na volta ela descarrega o que acumulou na janela.
+
+    python3 loadgen.py --devices 200 --duration 30
+    python3 loadgen.py --devices 500 --format get --period-ms 1000
+    python3 loadgen.py --devices 200 --outage-every 10 --outage-ms 4000 --outage-fraction 0.5
+"""
+
+from collections import Counter
+import argparse
+import asyncio
+import json
+import random
+import sys
+import time
+
+from server import DEVICE_ID_LEN, encode_batch
+
+# Mesmos limites do firmware (batch_window.h, uplink.h, main_wifi_safe.c)
+BATCH_WINDOW_SIZE = 8
+BATCH_WINDOW_REDELIVER_MS = 30000
+UPLINK_TIMEOUT_MS = 5000
+UPLINK_MAX_INFLIGHT = 3
+UPLINK_RETRY_POLL_MS = 500
+UPLINK_RATE_INITIAL_RPS = 0.333
+UPLINK_RATE_MIN_RPS = 0.1
+UPLINK_RATE_MAX_RPS = 5.0
+UPLINK_LATENCY_TARGET_MS = 1000
+SAMPLING_PERIOD_MIN_MS = 200
+SAMPLING_PERIOD_MAX_MS = 60000
+REPORT_EVERY_S = 5
+# Progresso e eventos (stderr com --json, para o resumo ficar sozinho no stdout)
+log_file = sys.stdout
+
+def log(message):
+    print(message, file=log_file, flush=True)
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(int(len(values) * p), len(values) - 1)]
+
+class RateCtl:
+    """rate_ctl.c em ponto flutuante: token bucket com AIMD"""
+
+    def __init__(self, now_ms):
+        self.rate = UPLINK_RATE_INITIAL_RPS
+        self.increase = (UPLINK_RATE_MAX_RPS - UPLINK_RATE_MIN_RPS) / 20 + 0.001
+        self.tokens = 1.0
+        self.last_refill_ms = now_ms
+        self.last_decrease_ms = now_ms - UPLINK_LATENCY_TARGET_MS
+
+    def acquire(self, now_ms):
+        """0 se pode enviar agora, senão quantos ms faltam"""
+        self.tokens = min(self.tokens + self.rate * (now_ms - self.last_refill_ms) / 1000,
+                          UPLINK_MAX_INFLIGHT)
+        self.last_refill_ms = now_ms
+        if self.tokens >= 1:
+            self.tokens -= 1
+            return 0
+        return (1 - self.tokens) * 1000 / self.rate
+
+    def on_result(self, ok, latency_ms, now_ms):
+        if ok and latency_ms <= UPLINK_LATENCY_TARGET_MS:
+            self.rate = min(self.rate + self.increase, UPLINK_RATE_MAX_RPS)
+            return
+        if now_ms - self.last_decrease_ms < UPLINK_LATENCY_TARGET_MS:
+            return
+        self.last_decrease_ms = now_ms
+        self.rate = max(self.rate / 2, UPLINK_RATE_MIN_RPS)
+        self.tokens = min(self.tokens, 1)
+
+class Metrics:
+    def __init__(self):
+        self.requests = 0
+        self.ok = 0
+        self.status = Counter()     # HTTP status ou tipo de erro
+        self.latency_ms = []
+        self.sample_age_ms = []     # Captura -> ACK (lotes) ou -> 200 (GET)
+        self.samples_sent = 0
+        self.samples_acked = 0
+        self.samples_dropped = 0    # Janela cheia (queda longa)
+        self.retransmits = 0
+        self.duplicates = 0
+        self.bytes_sent = 0
+
+    def errors(self):
+        """Requisições terminadas sem 2xx (as em curso não contam)"""
+        return sum(n for status, n in self.status.items()
+                   if not isinstance(status, int) or not 200 <= status < 300)
+
+class Device:
+    """Um dispositivo emulado: amostragem, janela de ACK e envio"""
+
+    def __init__(self, index, args, metrics):
+        self.index = index
+        self.args = args
+        self.metrics = metrics
+        self.device_id = (0x4C47 << 48 | index).to_bytes(DEVICE_ID_LEN, 'big')
+        self.stream_id = random.getrandbits(32)
+        self.period_ms = args.period_ms
+        self.batch = args.batch
+        self.online = True
+        self.next_seq = 0
+        self.pending = []           # Amostras ainda fora de um lote
+        self.window = {}            # seq -> lote (dict com samples, state, sends)
+        self.in_flight = 0
+        self.rate = RateCtl(time.monotonic() * 1000)
+        self.dist = random.randint(50, 1500)
+        self.wake = asyncio.Event()
+
+    def read_sensor(self):
+        self.dist = max(30, min(2000, self.dist + random.randint(-40, 40)))
+        return {'ts': int(time.time() * 1000), 'r': random.randint(0, 4000),
+                'g': random.randint(0, 4000), 'b': random.randint(0, 4000),
+                'c': random.randint(0, 12000), 'dist': self.dist,
+                'color_id': random.randint(0, 11)}
+
+    async def run(self, deadline):
+        # Dispositivos não ligam todos no mesmo instante
+        await asyncio.sleep(random.uniform(0, self.period_ms / 1000))
+        sender = asyncio.create_task(self.send_loop(deadline))
+        while time.monotonic() < deadline:
+            self.sample()
+            jitter = random.uniform(-self.args.jitter, self.args.jitter)
+            await asyncio.sleep(max(self.period_ms * (1 + jitter), 1) / 1000)
+        self.wake.set()
+        await sender
+
+    def sample(self):
+        self.pending.append(self.read_sensor())
+        if self.args.format == 'batch':
+            if len(self.pending) < self.batch:
+                return
+            if len(self.window) >= BATCH_WINDOW_SIZE:
+                oldest = min(self.window)
+                self.metrics.samples_dropped += len(self.window.pop(oldest)['samples'])
+            self.window[self.next_seq] = {'samples': self.pending, 'state': 'pending',
+                                          'sends': 0, 'delivered': 0}
+            self.next_seq += 1
+            self.pending = []
+        self.wake.set()
+
+    def next_batch(self, now_ms):
+        """Menor sequência a (re)enviar, como batch_window_take()"""
+        for seq in sorted(self.window):
+            entry = self.window[seq]
+            if entry['state'] == 'pending' or (
+                    entry['state'] == 'delivered' and
+                    now_ms - entry['delivered'] >= BATCH_WINDOW_REDELIVER_MS):
+                return seq, entry
+        return None, None
+
+    async def send_loop(self, deadline):
+        poll_s = UPLINK_RETRY_POLL_MS / 1000
+        while True:
+            try:
+                await asyncio.wait_for(self.wake.wait(), poll_s)
+            except asyncio.TimeoutError:
+                pass
+            self.wake.clear()
+            poll_s = UPLINK_RETRY_POLL_MS / 1000
+            if time.monotonic() >= deadline + UPLINK_TIMEOUT_MS / 1000 or (
+                    time.monotonic() >= deadline and not self.in_flight):
+                return
+            if not self.online or time.monotonic() >= deadline:
+                continue
+
+            # Mesmo limite do firmware: slots do uplink e token bucket
+            while self.in_flight < UPLINK_MAX_INFLIGHT:
+                now_ms = time.monotonic() * 1000
+                if self.args.format == 'get':
+                    seq, entry = None, self.pending[0] if self.pending else None
+                else:
+                    seq, entry = self.next_batch(now_ms)
+                if entry is None:
+                    break
+                wait_ms = self.rate.acquire(now_ms)
+                if wait_ms:
+                    poll_s = min(poll_s, wait_ms / 1000)
+                    break
+                self.in_flight += 1
+                if self.args.format == 'get':
+                    asyncio.create_task(self.send_get(self.pending.pop(0)))
+                else:
+                    entry['state'] = 'in_flight'
+                    asyncio.create_task(self.send_batch(seq, entry))
+
+    async def request(self, head, body=b''):
+        """Uma requisição com conexão nova; (status, corpo) ou (erro, None)"""
+        metrics = self.metrics
+        metrics.requests += 1
+        metrics.bytes_sent += len(head) + len(body)
+        start = time.perf_counter()
+        status, text = None, None
+        try:
+            reader, stream = await asyncio.wait_for(
+                asyncio.open_connection(self.args.host, self.args.port), UPLINK_TIMEOUT_MS / 1000)
+            try:
+                stream.write(head.encode() + body)
+                response = await asyncio.wait_for(reader.read(), UPLINK_TIMEOUT_MS / 1000)
+            finally:
+                stream.close()
+            head_end = response.find(b'\r\n\r\n')
+            status = int(response.split(b' ', 2)[1])
+            text = response[head_end + 4:].decode('latin-1') if head_end >= 0 else ''
+        except asyncio.TimeoutError:
+            status = 'timeout'
+        except ConnectionRefusedError:
+            status = 'refused'
+        except OSError:
+            status = 'conn_error'
+        except (IndexError, ValueError):
+            status = 'bad_response'
+
+        # Fim da requisição: libera o slot (o chamador o ocupou) e alimenta o
+        # AIMD como http_client_callback(): tudo fora de 2xx (429 da cota
+        # inclusive) é falha
+        latency_ms = (time.perf_counter() - start) * 1000
+        self.in_flight -= 1
+        ok = text is not None and 200 <= status < 300
+        self.rate.on_result(ok, latency_ms, time.monotonic() * 1000)
+        self.wake.set()
+
+        metrics.status[status] += 1
+        if text is None:
+            return status, None
+        if 200 <= status < 300:
+            metrics.ok += 1
+            metrics.latency_ms.append(latency_ms)
+        return status, text
+
+    def apply_control(self, body):
+        """Período e lote devolvidos pelo servidor, nas faixas do sampling_ctl.c"""
+        values = {}
+        for line in body.splitlines():
+            key, sep, value = line.partition('=')
+            if sep and value.isdigit():
+                values[key] = int(value)
+        if self.args.follow_control:
+            if 'period_ms' in values:
+                self.period_ms = min(max(values['period_ms'], SAMPLING_PERIOD_MIN_MS),
+                                     SAMPLING_PERIOD_MAX_MS)
+            if 'batch' in values:
+                self.batch = min(max(values['batch'], 1), self.args.batch)
+        return values
+
+    async def send_batch(self, seq, entry):
+        host = f"{self.args.host}:{self.args.port}"
+        base_seq = min(self.window)
+        body = encode_batch(entry['samples'], self.device_id, self.stream_id, seq, base_seq)
+        head = (f"POST /batch HTTP/1.1\r\nHost: {host}\r\n"
+                f"Content-Type: application/octet-stream\r\nContent-Length: {len(body)}\r\n"
+                f"Connection: close\r\n\r\n")
+        entry['sends'] += 1
+        if entry['sends'] > 1:
+            self.metrics.retransmits += 1
+        self.metrics.samples_sent += len(entry['samples'])
+
+        status, text = await self.request(head, body)
+        if seq not in self.window:
+            return
+        if text is None or not 200 <= status < 300:
+            entry['state'] = 'pending'
+            return
+        values = self.apply_control(text)
+        if 'dup' in values:
+            self.metrics.duplicates += 1
+        entry['state'] = 'delivered'
+        entry['delivered'] = time.monotonic() * 1000
+        if 'ack' in values:
+            now_ms = time.time() * 1000
+            for acked in [s for s in self.window if s <= values['ack']]:
+                done = self.window.pop(acked)
+                self.metrics.samples_acked += len(done['samples'])
+                self.metrics.sample_age_ms += [now_ms - s['ts'] for s in done['samples']]
+
+    async def send_get(self, sample):
+        host = f"{self.args.host}:{self.args.port}"
+        # Mesmos campos e ordem de serialize_sample() em main_wifi_safe.c
+        query = (f"?id={self.device_id.hex().upper()}&r={sample['r']}&g={sample['g']}&b={sample['b']}&c={sample['c']}"
+                 f"&dist={sample['dist']}&ts={sample['ts']}")
+        head = f"GET /data{query} HTTP/1.1\r\nHost: {host}\r\nConnection: close\r\n\r\n"
+        self.metrics.samples_sent += 1
+        status, text = await self.request(head)
+        if text is not None and 200 <= status < 300:
+            self.apply_control(text)
+            self.metrics.samples_acked += 1
+            self.metrics.sample_age_ms.append(time.time() * 1000 - sample['ts'])
+
+async def outages(devices, args, deadline):
+    """Rajadas de queda: uma fração da frota fica sem rede por outage_ms"""
+    while True:
+        await asyncio.sleep(args.outage_every)
+        if time.monotonic() >= deadline:
+            return
+        hit = random.sample(devices, max(1, int(len(devices) * args.outage_fraction)))
+        log(f"⚡ Queda: {len(hit)} dispositivos fora do ar por {args.outage_ms} ms")
+        for device in hit:
+            device.online = False
+        await asyncio.sleep(args.outage_ms / 1000)
+        for device in hit:
+            device.online = True
+            device.wake.set()
+
+async def report(metrics, started):
+    last_requests, last_acked = 0, 0
+    while True:
+        await asyncio.sleep(REPORT_EVERY_S)
+        log(f"📈 {time.monotonic() - started:5.0f} s: "
+              f"{(metrics.requests - last_requests) / REPORT_EVERY_S:.0f} req/s, "
+              f"{(metrics.samples_acked - last_acked) / REPORT_EVERY_S:.0f} amostras/s gravadas, "
+              f"{metrics.errors()} erros")
+        last_requests, last_acked = metrics.requests, metrics.samples_acked
+
+async def run(args):
+    metrics = Metrics()
+    devices = [Device(args.first_device + i, args, metrics) for i in range(args.devices)]
+    started = time.monotonic()
+    deadline = started + args.duration
+    tasks = [asyncio.create_task(report(metrics, started))]
+    if args.outage_every:
+        tasks.append(asyncio.create_task(outages(devices, args, deadline)))
+    await asyncio.gather(*(device.run(deadline) for device in devices))
+    for task in tasks:
+        task.cancel()
+    elapsed = time.monotonic() - started
+    return summarize(metrics, devices, elapsed)
+
+def summarize(metrics, devices, elapsed):
+    lat, age = metrics.latency_ms, metrics.sample_age_ms
+    unacked = sum(len(e['samples']) for d in devices for e in d.window.values())
+    unacked += sum(len(d.pending) for d in devices)
+    return {
+        'devices': len(devices),
+        'elapsed_s': round(elapsed, 1),
+        'requests': metrics.requests,
+        'requests_per_s': round(metrics.requests / elapsed, 1),
+        'ok': metrics.ok,
+        'error_rate': round(metrics.errors() / metrics.requests, 4) if metrics.requests else 0,
+        'status': {str(k): v for k, v in sorted(metrics.status.items(), key=str)},
+        'latency_ms': {'p50': round(percentile(lat, 0.5), 1), 'p90': round(percentile(lat, 0.9), 1),
+                       'p99': round(percentile(lat, 0.99), 1), 'max': round(max(lat, default=0), 1)},
+        'samples_sent': metrics.samples_sent,
+        'samples_acked': metrics.samples_acked,
+        'samples_acked_per_s': round(metrics.samples_acked / elapsed, 1),
+        'samples_unacked': unacked,
+        'samples_dropped': metrics.samples_dropped,
+        'retransmits': metrics.retransmits,
+        'duplicates': metrics.duplicates,
+        'sample_age_ms': {'p50': round(percentile(age, 0.5)), 'p99': round(percentile(age, 0.99)),
+                          'max': round(max(age, default=0))},
+        'kbytes_sent': round(metrics.bytes_sent / 1024, 1),
+    }
+
+def print_summary(s):
+    print("=" * 70)
+    print(f"Dispositivos: {s['devices']}, duração: {s['elapsed_s']} s")
+    print(f"Requisições: {s['requests']} ({s['requests_per_s']}/s), {s['ok']} OK, "
+          f"erros {s['error_rate'] * 100:.2f}% {s['status']}")
+    print(f"Latência (2xx): p50 {s['latency_ms']['p50']} ms, p90 {s['latency_ms']['p90']} ms, "
+          f"p99 {s['latency_ms']['p99']} ms, máx {s['latency_ms']['max']} ms")
+    print(f"Amostras: {s['samples_acked']} gravadas ({s['samples_acked_per_s']}/s), "
+          f"{s['samples_unacked']} sem ACK no fim, {s['samples_dropped']} descartadas "
+          f"(janela cheia)")
+    print(f"Retransmissões: {s['retransmits']}, duplicadas: {s['duplicates']}, "
+          f"enviados {s['kbytes_sent']} KiB")
+    print(f"Idade na gravação: p50 {s['sample_age_ms']['p50']} ms, "
+          f"p99 {s['sample_age_ms']['p99']} ms, máx {s['sample_age_ms']['max']} ms")
+    print("=" * 70)
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Frota de Pico W emulada contra o server.py")
+    parser.add_argument('--host', default='127.0.0.1')
+    parser.add_argument('--port', type=int, default=5000)
+    parser.add_argument('--devices', type=int, default=100)
+    parser.add_argument('--duration', type=float, default=30, help="segundos")
+    parser.add_argument('--first-device', type=int, default=0,
+                        help="índice do primeiro id (frotas paralelas sem colisão de ids)")
+    parser.add_argument('--format', choices=('batch', 'get'), default='batch',
+                        help="batch: POST /batch (padrão do firmware); get: GET /data")
+    parser.add_argument('--period-ms', type=int, default=1500,
+                        help="período inicial de leitura; o period_ms das respostas "
+                             "do servidor vale a partir daí, como no firmware")
+    parser.add_argument('--batch', type=int, default=8, help="amostras por lote (máx.)")
+    parser.add_argument('--jitter', type=float, default=0.1,
+                        help="variação do período, fração (0.1 = ±10%%)")
+    parser.add_argument('--no-follow-control', dest='follow_control', action='store_false',
+                        help="ignora period_ms/batch devolvidos pelo servidor")
+    parser.add_argument('--outage-every', type=float, default=0,
+                        help="uma rajada de quedas a cada N s (0 = sem quedas)")
+    parser.add_argument('--outage-ms', type=int, default=5000, help="duração de cada queda")
+    parser.add_argument('--outage-fraction', type=float, default=0.25,
+                        help="fração da frota derrubada em cada rajada")
+    parser.add_argument('--seed', type=int, help="semente do random (reprodutível)")
+    parser.add_argument('--json', action='store_true', help="resumo em JSON no stdout")
+    args = parser.parse_args()
+    args.batch = max(1, min(args.batch, 8))
+    if args.seed is not None:
+        random.seed(args.seed)
+
+    if args.json:
+        log_file = sys.stderr
+    log(f"🚚 {args.devices} dispositivos ({args.format}) -> {args.host}:{args.port} "
+        f"por {args.duration:.0f} s")
+    summary = asyncio.run(run(args))
+    if args.json:
+        print(json.dumps(summary, indent=2))
+    else:
+        print_summary(summary)
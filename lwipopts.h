@@ -11,6 +11,38 @@
 #define LWIP_DHCP                   1
 #define LWIP_TIMEVAL_PRIVATE        0
 
+// Pbufs customizados (pool de requisições do uplink)
+#define LWIP_SUPPORT_CUSTOM_PBUF    1
+
+// Servidor HTTP embarcado (device_httpd.c): CGI + arquivos gerados em
+// fs_open_custom(); estado das conexões em pool estático
+#define LWIP_HTTPD_CGI              1
+#define LWIP_HTTPD_SSI              0
+#define LWIP_HTTPD_CUSTOM_FILES     1
+#define LWIP_HTTPD_DYNAMIC_HEADERS  1
+#define HTTPD_USE_MEM_POOL          1
+#define MEMP_NUM_PARALLEL_HPCB      4
+// Respostas vêm de buffers reutilizados: o TCP precisa copiar os dados
+#define HTTP_IS_DATA_VOLATILE(hs)   TCP_WRITE_FLAG_COPY
+
+// SNTP (pico_lwip_sntp): cada resposta disciplina o relógio de device_clock.c.
+// A porta pode ser trocada no CMake (-DSNTP_PORT=...) para o stand-in do server.py
+#define SNTP_SERVER_DNS             0
+#define SNTP_STARTUP_DELAY          0
+#define SNTP_UPDATE_DELAY           300000      // 5 min, maior que a janela de slew
+#define SNTP_CHECK_RESPONSE         2           // Confere o originate timestamp
+#define SNTP_COMP_ROUNDTRIP         1
+#ifndef SNTP_PORT
+#define SNTP_PORT                   123
+#endif
+#ifndef __ASSEMBLER__
+#include <stdint.h>
+void device_clock_sntp_set(uint32_t sec, uint32_t us);
+void device_clock_sntp_get(uint32_t *sec, uint32_t *us);
+#endif
+#define SNTP_SET_SYSTEM_TIME_US(sec, us)    device_clock_sntp_set((uint32_t)(sec), (uint32_t)(us))
+#define SNTP_GET_SYSTEM_TIME(sec, us)       device_clock_sntp_get(&(sec), &(us))
+
 // FreeRTOS adjustments
 #define SYS_LIGHTWEIGHT_PROT        1
 #define MEM_ALIGNMENT               4
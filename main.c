@@ -9,11 +9,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 
 #include "ssd1306.h"
-#include "font.h"
+#include "ui.h"
 
 // ==================== DEFINIÇÕES I2C ====================
 // I2C0 para TCS34725 (Sensor de Cor)
@@ -28,6 +29,10 @@
 #define I2C1_SCL 3
 #define I2C1_FREQ 100000
 
+// ==================== DISPLAY ====================
+// Strings de cada caso na medição do texto no boot (0 = não mede)
+#define TEXT_BENCH_ITERATIONS 100
+
 // ==================== LEDs ====================
 // LED RGB (ajuste os pinos conforme seu hardware)
 #define LED_RED_PIN 13
@@ -324,6 +329,33 @@ void i2c_scan(i2c_inst_t *port, const char *name) {
         printf("\n");
 }
 
+// Compara o blitter de texto com o desenho pixel a pixel, nos tamanhos e
+// alinhamentos usados na tela (y = 3 força o caminho com máscara)
+void text_bench(ssd1306_t *disp) {
+    static const struct {
+        const char *str;
+        uint8_t scale;
+        int16_t y;
+    } cases[] = {
+        { "Dist: 1234 mm", 2, 0 },
+        { "Dist: 1234 mm", 2, 3 },
+        { "Cor: VERMELHO", 1, 24 },
+        { "Cor: VERMELHO", 1, 27 },
+        { "123", 3, 16 },
+    };
+
+    printf("\nTexto no SSD1306 (%d strings por caso):\n", TEXT_BENCH_ITERATIONS);
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        ssd1306_text_bench_t r;
+        ssd1306_bench_text(disp, 0, cases[i].y, cases[i].scale, cases[i].str,
+                           TEXT_BENCH_ITERATIONS, &r);
+        printf("  %-14s %ux y=%-2d  blit %6.1f us  pixel %7.1f us  (%.1fx)\n",
+               cases[i].str, cases[i].scale, cases[i].y, r.blit_us, r.pixel_us,
+               r.blit_us > 0 ? r.pixel_us / r.blit_us : 0.0f);
+    }
+    printf("\n");
+}
+
 // ==================== CONTROLE DE LED ====================
 void led_set_color(bool red, bool green, bool blue) {
     gpio_put(LED_RED_PIN, red);
@@ -334,9 +366,7 @@ void led_set_color(bool red, bool green, bool blue) {
 // ==================== MAIN ====================
 int main() {
     // SSD1306 config
-    #define SSD1306_WIDTH 128
-    #define SSD1306_HEIGHT 64
-    ssd1306_t disp;
+    static ssd1306_t disp;  // Framebuffer + cópia do painel: 2 KB, fora da pilha
     uint8_t ssd1306_addr = 0x3C;
     stdio_init_all();
     sleep_ms(1000); // Aguarda USB/serial estabilizar
@@ -407,12 +437,15 @@ int main() {
 
         // Inicializa o display SSD1306 antes de qualquer sensor
         printf("Inicializando SSD1306 no endereço 0x3C...\n");
-        ssd1306_init(&disp, I2C0_PORT, 0x3C);
+        ssd1306_init(&disp, I2C0_PORT, ssd1306_addr);
         printf("SSD1306 inicializado!\n");
         ssd1306_clear(&disp);
-        ssd1306_draw_string(&disp, 0, 0, "BitDogLab");
-        ssd1306_draw_string(&disp, 0, 16, "Sistema Inicializando...");
+        ssd1306_draw_string(&disp, 0, 0, 1, "BitDogLab");
+        ssd1306_draw_string(&disp, 0, 16, 1, "Inicializando...");
         ssd1306_show(&disp);
+#if TEXT_BENCH_ITERATIONS > 0
+        text_bench(&disp);
+#endif
         sleep_ms(1000);
 
         // Scanner I2C0 para detectar endereços
@@ -459,6 +492,14 @@ int main() {
     uint16_t r, g, b, c;
     uint16_t distance;
     uint8_t current_gain = TCS34725_GAIN_16X;
+
+    // Layout fixo do display: distância em 2x, barra de luz (canal clear) e cor
+    static ui_widget_t ui_distance, ui_light, ui_color;
+    ui_widget_t *const ui_widgets[] = { &ui_distance, &ui_light, &ui_color };
+    ui_value_init(&ui_distance, 0, 0, 2, 7, "%4ld mm", "---- mm");
+    ui_bar_init(&ui_light, 90, 17, 38, 6, UINT16_MAX);
+    ui_label_init(&ui_color, 0, 24, 1, 21, "Cor:");
+    ssd1306_clear(&disp);
     // Loop principal
     while (true) {
         // Ler sensor de cor
@@ -496,13 +537,13 @@ int main() {
         printf("| COR: %-18s                              |\n", cor);
         printf("|   R:%5u  G:%5u  B:%5u  C:%5u  GANHO:%dx         |\n", r, g, b, c, (1 << (2*current_gain)));
 
-        // Exibir distância no display
-        char linha1[22], linha2[22];
-        snprintf(linha1, sizeof(linha1), "Dist: %4d mm", distance == 0xFFFF ? -1 : distance);
-        snprintf(linha2, sizeof(linha2), "Cor: %s", cor);
-        ssd1306_clear(&disp);
-        ssd1306_draw_string(&disp, 0, 0, 2, linha1);
-        ssd1306_draw_string(&disp, 0, 24, 1, linha2);
+        // Exibir no display: só os widgets com valor novo são redesenhados
+        char linha_cor[UI_TEXT_MAX + 1];
+        snprintf(linha_cor, sizeof(linha_cor), "Cor: %s", cor);
+        ui_value_set(&ui_distance, distance, distance != 0xFFFF);
+        ui_bar_set(&ui_light, c);
+        ui_label_set(&ui_color, linha_cor);
+        ui_draw(&disp, ui_widgets, sizeof(ui_widgets) / sizeof(ui_widgets[0]));
         ssd1306_show(&disp);
         // Informações de Distância
         if (distance == 0xFFFF) {
@@ -6,18 +6,87 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "semphr.h"
 #include <stdio.h>
 #include <string.h>
 #include "pico/stdlib.h"
 #include "pico/cyw43_arch.h"
 #include "hardware/i2c.h"
+#include "pico/unique_id.h"
+#include "pico/rand.h"
+#include "lwip/dhcp.h"
+#include "lwip/netif.h"
+#include "lwip/apps/sntp.h"
+
+#include "batch_window.h"
+#include "chart.h"
+#include "cpu_cores.h"
+#include "device_clock.h"
+#include "device_httpd.h"
+#include "display.h"
+#include "radio_window.h"
+#include "rate_ctl.h"
+#include "sample_codec.h"
+#include "sample_ring.h"
+#include "sampling_ctl.h"
+#include "server_pool.h"
+#include "ui.h"
+#include "uplink.h"
+#include "wifi_cache.h"
+#if UPLINK_LEGACY_BENCH > 0
 #include "lwip/apps/http_client.h"
+#endif
 
 // ==================== CONFIGURAÇÕES WiFi/HTTP ====================
 #define WIFI_SSID       "DRACON"
 #define WIFI_PASSWORD   "am3426bn14"
 #define SERVER_IP       "192.168.1.100"
 #define SERVER_PORT     5000
+// Servidor SNTP (sem DNS): por padrão o stand-in do server.py (--ntp-port);
+// a porta vem do CMake (SNTP_PORT)
+#define SNTP_SERVER_IP  SERVER_IP
+
+// Servidores de ingestão: cada envio vai para o de menor RTT/taxa de falhas e
+// muda para outro quando um trava ou cai (server_pool.h)
+static const struct {
+    const char *ip;
+    uint16_t port;
+} ingest_servers[] = {
+    { SERVER_IP, SERVER_PORT },
+    // { "192.168.1.101", 5000 },
+};
+
+// Formato do uplink: 1 = lotes binários (POST /batch), 0 = uma amostra por GET /data
+#define UPLINK_FORMAT_BINARY        1
+#define UPLINK_BATCH_SIZE           8
+#define UPLINK_BATCH_TIMEOUT_MS     15000
+#define UPLINK_SLOT_WAIT_MS         100
+// Com lotes aguardando retransmissão, a coleta não bloqueia mais que isso
+#define UPLINK_RETRY_POLL_MS        500
+
+// Janelas de rádio: PM1 entre envios, desempenho máximo só enquanto um lote
+// é enviado (radio_window.h). 0 = power-save padrão do driver o tempo todo
+#define UPLINK_RADIO_WINDOWS        1
+
+#if UPLINK_BATCH_SIZE > BATCH_WINDOW_MAX_SAMPLES
+#error "UPLINK_BATCH_SIZE maior que BATCH_WINDOW_MAX_SAMPLES"
+#endif
+
+// Controle de taxa (token bucket + AIMD), em requisições/s x 1000
+#define UPLINK_RATE_INITIAL_MRPS    333     // ~1 requisição a cada 3 s
+#define UPLINK_RATE_MIN_MRPS        100     // Piso sob falhas: 1 a cada 10 s
+#define UPLINK_RATE_MAX_MRPS        5000
+#define UPLINK_RATE_BURST           UPLINK_MAX_INFLIGHT
+#define UPLINK_LATENCY_TARGET_MS    1000    // Acima disso o servidor está sobrecarregado
+
+// Timeouts de conexão: rejoin direcionado (canal/BSSID/IP em cache) e varredura completa
+#define WIFI_FAST_JOIN_TIMEOUT_MS   5000
+#define WIFI_FULL_JOIN_TIMEOUT_MS   30000
+
+// Canal atual (WLC_GET_CHANNEL), caso o driver não exporte a constante
+#ifndef CYW43_IOCTL_GET_CHANNEL
+#define CYW43_IOCTL_GET_CHANNEL     0x3a
+#endif
 
 // ==================== I2C ====================
 #define I2C0_PORT i2c0
@@ -25,6 +94,14 @@
 #define I2C0_SCL 1
 #define I2C0_FREQ 400000
 
+// Display SSD1306 no mesmo I2C0 do TCS34725 (i2c0_mutex)
+#define DISPLAY_I2C_ADDR SSD1306_I2C_ADDR
+// Histórico da distância entre a linha da cor e a do WiFi: uma coluna por
+// leitura, 127 visíveis (~3 min no período padrão de 1,5 s)
+#define DISPLAY_CHART_Y         32
+#define DISPLAY_CHART_HEIGHT    24
+#define DISPLAY_CHART_STEP_MM   50
+
 #define I2C1_PORT i2c1
 #define I2C1_SDA 2
 #define I2C1_SCL 3
@@ -56,19 +133,24 @@
 #define VL53L0X_REG_SYSRANGE_START 0x00
 #define VL53L0X_REG_RESULT_RANGE_STATUS 0x14
 
-// ==================== Estrutura de Dados ====================
-typedef struct {
-    uint16_t red;
-    uint16_t green;
-    uint16_t blue;
-    uint16_t clear;
-    uint16_t distance;
-} SensorData;
-
 // ==================== Variáveis Globais ====================
 QueueHandle_t xQueueSensorData;
 static volatile bool wifi_connected = false;
-static volatile bool requisicao_em_curso = false;
+
+// Tempo de conexão WiFi (modo STA ligado -> link com IP) e caminho usado;
+// não inclui o cyw43_arch_init(), que é igual nos dois caminhos
+static uint32_t wifi_connect_ms = 0;
+static bool wifi_fast_path = false;
+
+// Atualizado pelo http_task e pelo callback do uplink (contexto do lwIP)
+static rate_ctl_t uplink_rate;
+
+// Notificada quando o servidor muda o período de amostragem
+static TaskHandle_t sensor_task_handle = NULL;
+
+// I2C0 é dividido entre o TCS34725 (task de sensores) e o display (task do
+// display); cada transação completa fica sob o mutex
+static SemaphoreHandle_t i2c0_mutex = NULL;
 
 // ==================== FreeRTOS Static Memory ====================
 void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize) {
@@ -90,7 +172,9 @@ void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackT
 // ==================== TCS34725 Functions ====================
 void tcs34725_write_byte(uint8_t reg, uint8_t value) {
     uint8_t buf[2] = {TCS34725_COMMAND_BIT | reg, value};
+    xSemaphoreTake(i2c0_mutex, portMAX_DELAY);
     i2c_write_blocking(I2C0_PORT, TCS34725_ADDR, buf, 2, false);
+    xSemaphoreGive(i2c0_mutex);
 }
 
 uint16_t tcs34725_read_word(uint8_t reg) {
@@ -113,10 +197,12 @@ bool tcs34725_init() {
 }
 
 void tcs34725_read_colors(uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *c) {
+    xSemaphoreTake(i2c0_mutex, portMAX_DELAY);
     *c = tcs34725_read_word(TCS34725_CDATAL);
     *r = tcs34725_read_word(TCS34725_RDATAL);
     *g = tcs34725_read_word(TCS34725_GDATAL);
     *b = tcs34725_read_word(TCS34725_BDATAL);
+    xSemaphoreGive(i2c0_mutex);
 }
 
 // ==================== VL53L0X Functions ====================
@@ -185,18 +271,18 @@ void led_set_color(bool red, bool green, bool blue) {
     gpio_put(LED_BLUE_PIN, blue);
 }
 
-// ==================== Detectar Nome da Cor ====================
-const char* get_color_name(uint16_t r, uint16_t g, uint16_t b) {
+// ==================== Detectar Cor ====================
+sample_color_t get_color_id(uint16_t r, uint16_t g, uint16_t b) {
     // Encontrar o valor máximo
     uint16_t max_val = r;
     if (g > max_val) max_val = g;
     if (b > max_val) max_val = b;
     
     // Se todos os valores são muito baixos, é preto
-    if (max_val < 50) return "PRETO";
+    if (max_val < 50) return SAMPLE_COLOR_PRETO;
     
     // Se todos os valores são altos e próximos, é branco
-    if (r > 200 && g > 200 && b > 200) return "BRANCO";
+    if (r > 200 && g > 200 && b > 200) return SAMPLE_COLOR_BRANCO;
     
     // Calcular diferenças relativas
     float r_ratio = (float)r / max_val;
@@ -204,55 +290,411 @@ const char* get_color_name(uint16_t r, uint16_t g, uint16_t b) {
     float b_ratio = (float)b / max_val;
     
     // Vermelho dominante
-    if (r_ratio > 0.8 && g_ratio < 0.5 && b_ratio < 0.5) return "VERMELHO";
+    if (r_ratio > 0.8 && g_ratio < 0.5 && b_ratio < 0.5) return SAMPLE_COLOR_VERMELHO;
     
     // Verde dominante
-    if (g_ratio > 0.8 && r_ratio < 0.5 && b_ratio < 0.5) return "VERDE";
+    if (g_ratio > 0.8 && r_ratio < 0.5 && b_ratio < 0.5) return SAMPLE_COLOR_VERDE;
     
     // Azul dominante
-    if (b_ratio > 0.8 && r_ratio < 0.5 && g_ratio < 0.5) return "AZUL";
+    if (b_ratio > 0.8 && r_ratio < 0.5 && g_ratio < 0.5) return SAMPLE_COLOR_AZUL;
     
     // Amarelo (R+G altos, B baixo)
-    if (r_ratio > 0.7 && g_ratio > 0.7 && b_ratio < 0.5) return "AMARELO";
+    if (r_ratio > 0.7 && g_ratio > 0.7 && b_ratio < 0.5) return SAMPLE_COLOR_AMARELO;
     
     // Ciano (G+B altos, R baixo)
-    if (g_ratio > 0.7 && b_ratio > 0.7 && r_ratio < 0.5) return "CIANO";
+    if (g_ratio > 0.7 && b_ratio > 0.7 && r_ratio < 0.5) return SAMPLE_COLOR_CIANO;
     
     // Magenta (R+B altos, G baixo)
-    if (r_ratio > 0.7 && b_ratio > 0.7 && g_ratio < 0.5) return "MAGENTA";
+    if (r_ratio > 0.7 && b_ratio > 0.7 && g_ratio < 0.5) return SAMPLE_COLOR_MAGENTA;
     
     // Laranja (R alto, G médio, B baixo)
-    if (r_ratio > 0.9 && g_ratio > 0.4 && g_ratio < 0.7 && b_ratio < 0.4) return "LARANJA";
+    if (r_ratio > 0.9 && g_ratio > 0.4 && g_ratio < 0.7 && b_ratio < 0.4) return SAMPLE_COLOR_LARANJA;
     
     // Cinza (todos próximos mas não muito altos)
     if (r > 80 && g > 80 && b > 80 && r < 200 && g < 200 && b < 200) {
         float diff_rg = (r > g) ? (float)(r - g) / max_val : (float)(g - r) / max_val;
         float diff_rb = (r > b) ? (float)(r - b) / max_val : (float)(b - r) / max_val;
         float diff_gb = (g > b) ? (float)(g - b) / max_val : (float)(b - g) / max_val;
-        if (diff_rg < 0.2 && diff_rb < 0.2 && diff_gb < 0.2) return "CINZA";
+        if (diff_rg < 0.2 && diff_rb < 0.2 && diff_gb < 0.2) return SAMPLE_COLOR_CINZA;
     }
     
     // Marrom (R>G>B, valores médios)
-    if (r > g && g > b && r < 150 && g < 100) return "MARROM";
+    if (r > g && g > b && r < 150 && g < 100) return SAMPLE_COLOR_MARROM;
     
-    return "INDEFINIDO";
+    return SAMPLE_COLOR_INDEFINIDO;
 }
 
 // ==================== HTTP Callback ====================
-static void http_client_callback(void *arg, httpc_result_t httpc_result, u32_t rx_content_len, u32_t srv_res, err_t err) {
-    requisicao_em_curso = false;
-    if (httpc_result == HTTPC_RESULT_OK) {
-        printf("HTTP: OK (Status %d)\n", (int)srv_res);
+static void uplink_rate_feedback(bool ok, uint32_t latency_ms) {
+    taskENTER_CRITICAL();
+    rate_ctl_on_result(&uplink_rate, ok, latency_ms, to_ms_since_boot(get_absolute_time()));
+    taskEXIT_CRITICAL();
+}
+
+// Retorna 0 se pode enviar agora, ou quantos ms esperar pelo próximo token
+static uint32_t uplink_rate_acquire(void) {
+    taskENTER_CRITICAL();
+    uint32_t wait_ms = rate_ctl_acquire(&uplink_rate, to_ms_since_boot(get_absolute_time()));
+    taskEXIT_CRITICAL();
+    return wait_ms;
+}
+
+// Ajustes da frota vindos do servidor (period_ms=, batch=, delta=)
+static void apply_server_control(const uplink_response_t *resp) {
+    uint32_t period_ms = SAMPLING_KEEP;
+    uint32_t batch = SAMPLING_KEEP;
+    uint32_t delta = SAMPLING_KEEP;
+
+    uplink_response_get_uint(resp, "period_ms", &period_ms);
+    uplink_response_get_uint(resp, "batch", &batch);
+    uplink_response_get_uint(resp, "delta", &delta);
+    if (!sampling_ctl_set(period_ms, batch, delta)) {
+        return;
+    }
+
+    sampling_ctl_t ctl;
+    sampling_ctl_get(&ctl);
+    printf("Controle: periodo %lu ms, lote %lu, delta %lu\n", (unsigned long)ctl.period_ms,
+           (unsigned long)ctl.batch_size, (unsigned long)ctl.delta);
+    // Acorda a tarefa de sensores para o novo período valer já
+    if (sensor_task_handle) {
+        xTaskNotifyGive(sensor_task_handle);
+    }
+}
+
+// arg = sequência do lote (binário) ou número da requisição (GET); várias
+// podem estar em curso ao mesmo tempo
+static void http_client_callback(void *arg, const uplink_response_t *resp) {
+    unsigned long id = (unsigned long)(uintptr_t)arg;
+    bool ok = resp->result == UPLINK_RESULT_OK &&
+              resp->http_status >= 200 && resp->http_status < 300;
+
+    uplink_rate_feedback(ok, resp->latency_ms);
+    // Para a seleção de servidor, 4xx é problema da requisição, não do servidor
+    server_pool_result(resp->server, resp->port,
+                       resp->result == UPLINK_RESULT_OK && resp->http_status < 500,
+                       resp->latency_ms, to_ms_since_boot(get_absolute_time()));
+    if (ok) {
+        apply_server_control(resp);
+    }
+#if UPLINK_FORMAT_BINARY
+    // Sem ACK o lote volta para a fila; o ACK cumulativo libera a janela
+    uint32_t ack = 0;
+    bool has_ack = ok && uplink_response_get_uint(resp, "ack", &ack);
+    batch_window_result((uint32_t)id, ok, has_ack, ack, to_ms_since_boot(get_absolute_time()));
+#endif
+    if (resp->result == UPLINK_RESULT_OK) {
+        printf("HTTP #%lu: OK (Status %d, %lu ms)\n", id, (int)resp->http_status,
+               (unsigned long)resp->latency_ms);
+    } else if (resp->result == UPLINK_RESULT_TIMEOUT) {
+        printf("HTTP #%lu: Timeout\n", id);
     } else {
-        printf("HTTP: Falha %d\n", (int)httpc_result);
+        printf("HTTP #%lu: Falha %d\n", id, (int)resp->result);
     }
 }
 
+static bool sample_in_range(const SensorData *data) {
+    return data->distance != 0xFFFF && data->distance < 2000;
+}
+
+static void print_uplink_stats(void) {
+    uplink_stats_t stats;
+    uplink_get_stats(&stats);
+    if (stats.requests == 0) {
+        return;
+    }
+    // Cópias no tcp_write(): só medidas na comparação (UPLINK_LEGACY_BENCH)
+    printf("Uplink: %lu req, %lu amostras | bytes/amostra: %lu serializados"
+           " | pool esgotado: %lu\n",
+           (unsigned long)stats.requests, (unsigned long)stats.samples,
+           (unsigned long)(stats.bytes_serialized / stats.samples),
+           (unsigned long)stats.pool_exhausted);
+    printf("Uplink: em curso %lu, concluidas %lu, falhas %lu, timeouts %lu, tabela cheia %lu\n",
+           (unsigned long)stats.in_flight, (unsigned long)stats.completed,
+           (unsigned long)stats.failed, (unsigned long)stats.timed_out,
+           (unsigned long)stats.table_full);
+
+    taskENTER_CRITICAL();
+    rate_ctl_t rc = uplink_rate;
+    taskEXIT_CRITICAL();
+    printf("Uplink: taxa %lu.%03lu req/s, latencia media %lu ms, +%lu/-%lu ajustes, espera %lu ms\n",
+           (unsigned long)(rc.rate_mrps / 1000), (unsigned long)(rc.rate_mrps % 1000),
+           (unsigned long)rc.latency_ewma_ms, (unsigned long)rc.increases,
+           (unsigned long)rc.decreases, (unsigned long)rc.throttled_ms);
+
+    radio_window_stats_t radio;
+    radio_window_get_stats(&radio);
+    printf("Radio: %lu janelas, ativo %lu.%lu%% do tempo, latencia por amostra %lu ms (max %lu)\n",
+           (unsigned long)radio.windows, (unsigned long)(radio.duty_permille / 10),
+           (unsigned long)(radio.duty_permille % 10),
+           (unsigned long)(radio.samples ? radio.latency_sum_ms / radio.samples : 0),
+           (unsigned long)radio.latency_max_ms);
+
+    server_pool_stats_t pool;
+    server_pool_get_stats(&pool);
+    for (int i = 0; i < (int)pool.count; i++) {
+        server_endpoint_t ep;
+        server_pool_get(i, &ep);
+        printf("Servidor %d%s: %s:%u rtt %lu ms, falhas %lu.%lu%%, %lu req%s\n", i,
+               i == pool.current ? "*" : "", ipaddr_ntoa(&ep.addr), (unsigned)ep.port,
+               (unsigned long)ep.rtt_ewma_ms, (unsigned long)(ep.fail_permille / 10),
+               (unsigned long)(ep.fail_permille % 10), (unsigned long)ep.requests,
+               ep.down ? " (fora)" : "");
+    }
+    if (pool.count > 1) {
+        printf("Servidores: %lu trocas por falha, %lu exploracoes, %lu testes\n",
+               (unsigned long)pool.failovers, (unsigned long)pool.explores,
+               (unsigned long)pool.probes);
+    }
+
+#if UPLINK_FORMAT_BINARY
+    batch_window_stats_t bw;
+    batch_window_get_stats(&bw);
+    printf("Uplink: lotes %lu, ack ate #%lu, na janela %lu, retransmissoes %lu, descartados %lu (%lu amostras)\n",
+           (unsigned long)bw.pushed, (unsigned long)bw.last_ack, (unsigned long)bw.in_window,
+           (unsigned long)bw.retransmits, (unsigned long)bw.dropped_batches,
+           (unsigned long)bw.dropped_samples);
+#endif
+}
+
+static void start_httpd(void) {
+    device_httpd_init();
+    printf("HTTPD: /latest, /history?n=, /metrics na porta 80\n");
+}
+
 // ==================== TASK: HTTP ====================
+#if UPLINK_FORMAT_BINARY
+static void put_uplink_byte(void *ctx, uint8_t byte) {
+    uplink_put_byte((uplink_writer_t *)ctx, byte);
+}
+
+// Coleta até o tamanho de lote atual (definido pelo servidor, no máximo
+// UPLINK_BATCH_SIZE) amostras válidas; o prazo começa na primeira, que é
+// aguardada por no máximo first_wait
+static size_t collect_batch(SensorData *batch, TickType_t first_wait) {
+    size_t count = 0;
+    TickType_t start = 0;
+
+    while (count < sampling_ctl_batch_size()) {
+        TickType_t wait = first_wait;
+        if (count > 0) {
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            TickType_t timeout = pdMS_TO_TICKS(UPLINK_BATCH_TIMEOUT_MS);
+            wait = elapsed < timeout ? timeout - elapsed : 0;
+        }
+        if (!xQueueReceive(xQueueSensorData, &batch[count], wait)) {
+            break;
+        }
+        if (!sample_in_range(&batch[count])) {
+            continue;
+        }
+        if (count == 0) {
+            start = xTaskGetTickCount();
+        }
+        count++;
+    }
+    return count;
+}
+
+static err_t send_batch(batch_entry_t *entry, uint32_t base_seq, const server_endpoint_t *server) {
+    static sample_batch_header_t header;
+    static bool header_ok = false;
+    uplink_writer_t w;
+
+    if (!header_ok) {
+        pico_unique_board_id_t board_id;
+        pico_get_unique_board_id(&board_id);
+        memcpy(header.device_id, board_id.id, sizeof(header.device_id));
+        header.stream_id = batch_window_stream_id();
+        header_ok = true;
+    }
+
+    // Amostras lidas antes da primeira sincronização SNTP ainda estão em ms
+    // desde o boot
+    for (size_t i = 0; i < entry->count; i++) {
+        entry->samples[i].timestamp_ms = device_clock_absolute_ms(entry->samples[i].timestamp_ms);
+    }
+
+    // Latência de agrupamento + janela: só no primeiro envio de cada lote
+    if (entry->sends == 1) {
+        uint64_t now = device_clock_now_ms();
+        for (size_t i = 0; i < entry->count; i++) {
+            uint64_t ts = entry->samples[i].timestamp_ms;
+            radio_window_note_sample(now > ts ? (uint32_t)(now - ts) : 0);
+        }
+    }
+
+    header.seq = entry->seq;
+    header.base_seq = base_seq;
+    header.count = entry->count;
+    if (!uplink_begin_body(&w)) {
+        return ERR_MEM;
+    }
+    size_t len = sample_codec_encode(&header, entry->samples, put_uplink_byte, &w);
+    printf("HTTP: Enviando lote #%lu%s de %u amostras (%u bytes)...\n",
+           (unsigned long)entry->seq, entry->sends > 1 ? " (retransmissao)" : "",
+           (unsigned)entry->count, (unsigned)len);
+    return uplink_send_post(&w, "/batch", entry->count, &server->addr, server->port,
+                            http_client_callback, (void *)(uintptr_t)entry->seq);
+}
+#endif
+
+#if !UPLINK_FORMAT_BINARY || UPLINK_LEGACY_BENCH > 0
+// Serializa a amostra direto nos pbufs do pool do uplink (sem snprintf)
+static void serialize_sample(uplink_writer_t *w, const SensorData *data) {
+    // Mesmo id do cabeçalho dos lotes: o servidor separa filas e cotas por ele
+    static char device_id[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1];
+    if (!device_id[0]) {
+        pico_get_unique_board_id_string(device_id, sizeof(device_id));
+    }
+    uplink_put_str(w, "?id=");
+    uplink_put_str(w, device_id);
+    uplink_put_str(w, "&r=");
+    uplink_put_uint(w, data->red);
+    uplink_put_str(w, "&g=");
+    uplink_put_uint(w, data->green);
+    uplink_put_str(w, "&b=");
+    uplink_put_uint(w, data->blue);
+    uplink_put_str(w, "&c=");
+    uplink_put_uint(w, data->clear);
+    uplink_put_str(w, "&dist=");
+    uplink_put_uint(w, data->distance);
+    // Só envia o horário de captura se ele for absoluto (relógio sincronizado)
+    uint64_t ts = device_clock_absolute_ms(data->timestamp_ms);
+    if (ts >= DEVICE_CLOCK_EPOCH_MIN_MS) {
+        uplink_put_str(w, "&ts=");
+        uplink_put_uint64(w, ts);
+    }
+}
+#endif
+
+#if !UPLINK_FORMAT_BINARY
+static err_t send_sample(const SensorData *data, const server_endpoint_t *server, void *ctx) {
+    uplink_writer_t w;
+    if (!uplink_begin_get(&w, "/data")) {
+        return ERR_MEM;
+    }
+    serialize_sample(&w, data);
+    uint64_t now = device_clock_now_ms();
+    uint64_t ts = device_clock_absolute_ms(data->timestamp_ms);
+    radio_window_note_sample(now > ts ? (uint32_t)(now - ts) : 0);
+    printf("HTTP: Enviando dist=%dmm...\n", data->distance);
+    return uplink_send(&w, &server->addr, server->port, http_client_callback, ctx);
+}
+#endif
+
+#if UPLINK_LEGACY_BENCH > 0
+static volatile bool bench_done;
+
+static void legacy_result(void *arg, httpc_result_t httpc_result, u32_t rx_content_len,
+                          u32_t srv_res, err_t err) {
+    bench_done = true;
+}
+
+static void bench_uplink_result(void *arg, const uplink_response_t *resp) {
+    bench_done = true;
+}
+
+// Bytes que o tcp_write() copiou (COPY) durante um envio, esperando o fim da
+// requisição; o httpd só sobe depois da comparação, então só há este envio
+static bool bench_wait(err_t err, uint32_t before, uint32_t *copied) {
+    if (err != ERR_OK) {
+        printf("Uplink (comparacao): erro %d\n", (int)err);
+        return false;
+    }
+    while (!bench_done) {
+        vTaskDelay(pdMS_TO_TICKS(UPLINK_SLOT_WAIT_MS));
+    }
+    *copied += uplink_tcp_copied_bytes() - before;
+    return true;
+}
+
+// A mesma amostra real pelo envio de antes do uplink (snprintf da URI +
+// httpc_get_file(), que monta a requisição num pbuf próprio e a entrega ao
+// tcp_write() com COPY) e pelo GET do uplink; essas amostras não seguem
+// pelo envio normal
+static void legacy_uplink_bench(const server_endpoint_t *server) {
+    uint32_t legacy_sent = 0;
+    uint32_t uplink_sent = 0;
+    uint32_t uri_bytes = 0;
+    uint32_t legacy_copied = 0;
+    uint32_t uplink_copied = 0;
+    uplink_stats_t before_stats;
+    uplink_stats_t after_stats;
+    SensorData data;
+
+    printf("Uplink antigo: %d amostras pelos dois caminhos...\n", UPLINK_LEGACY_BENCH);
+    uplink_get_stats(&before_stats);
+    for (int i = 0; i < UPLINK_LEGACY_BENCH; i++) {
+        xQueueReceive(xQueueSensorData, &data, portMAX_DELAY);
+
+        httpc_connection_t settings;
+        memset(&settings, 0, sizeof(settings));
+        settings.result_fn = legacy_result;
+        char uri[128];
+        int len = snprintf(uri, sizeof(uri), "/data?r=%d&g=%d&b=%d&c=%d&dist=%d",
+                           data.red, data.green, data.blue, data.clear, data.distance);
+        bench_done = false;
+        uint32_t before = uplink_tcp_copied_bytes();
+        cyw43_arch_lwip_begin();
+        err_t err = httpc_get_file(&server->addr, server->port, uri, &settings, NULL, NULL, NULL);
+        cyw43_arch_lwip_end();
+        if (bench_wait(err, before, &legacy_copied)) {
+            legacy_sent++;
+            uri_bytes += (uint32_t)len;
+        }
+
+        uplink_writer_t w;
+        if (!uplink_begin_get(&w, "/data")) {
+            continue;
+        }
+        serialize_sample(&w, &data);
+        bench_done = false;
+        before = uplink_tcp_copied_bytes();
+        err = uplink_send(&w, &server->addr, server->port, bench_uplink_result, NULL);
+        if (bench_wait(err, before, &uplink_copied)) {
+            uplink_sent++;
+        }
+    }
+    uplink_get_stats(&after_stats);
+    if (legacy_sent) {
+        // O pbuf do httpc tem a requisição inteira: a mesma contagem do tcp_write
+        printf("Uplink antigo: %lu req | bytes/amostra: %lu na URI (snprintf), "
+               "%lu copiados pelo tcp_write (COPY)\n",
+               (unsigned long)legacy_sent, (unsigned long)(uri_bytes / legacy_sent),
+               (unsigned long)(legacy_copied / legacy_sent));
+    }
+    if (uplink_sent) {
+        printf("Uplink atual:  %lu req | bytes/amostra: %lu serializados, "
+               "%lu copiados pelo tcp_write (COPY)\n",
+               (unsigned long)uplink_sent,
+               (unsigned long)((after_stats.bytes_serialized - before_stats.bytes_serialized) /
+                               uplink_sent),
+               (unsigned long)(uplink_copied / uplink_sent));
+    }
+}
+#endif
+
 void http_task(void *pvParameters) {
+#if UPLINK_FORMAT_BINARY
+    static SensorData batch[UPLINK_BATCH_SIZE];
+    static batch_entry_t entry;
+#else
     SensorData data;
-    ip_addr_t server_addr;
-    ip4addr_aton(SERVER_IP, &server_addr);
+#endif
+    server_pool_init();
+    for (size_t i = 0; i < sizeof(ingest_servers) / sizeof(ingest_servers[0]); i++) {
+        if (!server_pool_add(ingest_servers[i].ip, ingest_servers[i].port)) {
+            printf("HTTP: servidor %s:%u ignorado\n", ingest_servers[i].ip,
+                   (unsigned)ingest_servers[i].port);
+        }
+    }
+    server_pool_stats_t pool;
+    server_pool_get_stats(&pool);
+    if (pool.count == 0) {
+        printf("HTTP Task: nenhum servidor de ingestao valido\n");
+        vTaskDelete(NULL);
+    }
 
     printf("HTTP Task: Aguardando WiFi...\n");
     
@@ -262,64 +704,158 @@ void http_task(void *pvParameters) {
     }
     
     printf("HTTP Task: WiFi OK, iniciando envios...\n");
+    uplink_init();
+    rate_ctl_init(&uplink_rate, UPLINK_RATE_INITIAL_MRPS, UPLINK_RATE_MIN_MRPS,
+                  UPLINK_RATE_MAX_MRPS, UPLINK_RATE_BURST, UPLINK_LATENCY_TARGET_MS,
+                  to_ms_since_boot(get_absolute_time()));
+    device_httpd_set_rate_ctl(&uplink_rate);
+    radio_window_init(UPLINK_RADIO_WINDOWS);
+#if UPLINK_LEGACY_BENCH > 0
+    server_endpoint_t bench_server;
+    server_pool_get(0, &bench_server);
+    legacy_uplink_bench(&bench_server);
+    start_httpd();
+#endif
+#if UPLINK_FORMAT_BINARY
+    // Stream novo a cada boot: o servidor recomeça a janela de ACK
+    batch_window_init(get_rand_32());
+#endif
+    uint32_t sent_count = 0;
 
     while (true) {
-        if (xQueueReceive(xQueueSensorData, &data, portMAX_DELAY)) {
-            
-            // NÃO enviar se distância inválida ou fora de alcance
-            if (data.distance == 0xFFFF || data.distance >= 2000) {
-                printf("HTTP: Dados fora de alcance, pulando envio\n");
-                vTaskDelay(pdMS_TO_TICKS(1000));
-                continue;
-            }
-            
-            // Aguardar requisição anterior terminar
-            int wait_count = 0;
-            while (requisicao_em_curso && wait_count < 10) {
-                vTaskDelay(pdMS_TO_TICKS(500));
-                wait_count++;
+#if UPLINK_FORMAT_BINARY
+        TickType_t first_wait = batch_window_busy() ? pdMS_TO_TICKS(UPLINK_RETRY_POLL_MS)
+                                                    : portMAX_DELAY;
+        size_t count = collect_batch(batch, first_wait);
+        if (count > 0) {
+            batch_window_push(batch, count);
+        }
+
+        // Lote novo ou retransmissão, sempre o de menor sequência pendente
+        uint32_t base_seq;
+        if (!batch_window_take(&entry, &base_seq, to_ms_since_boot(get_absolute_time()))) {
+            continue;
+        }
+#else
+        if (!xQueueReceive(xQueueSensorData, &data, portMAX_DELAY)) {
+            continue;
+        }
+
+        // NÃO enviar se distância inválida ou fora de alcance (não consome token)
+        if (!sample_in_range(&data)) {
+            printf("HTTP: Dados fora de alcance, pulando envio\n");
+            continue;
+        }
+#endif
+
+        // Janela de rádio: sai do power-save só enquanto houver o que enviar
+        radio_window_open();
+        bool more;
+        do {
+            // Token bucket no lugar do atraso fixo entre requisições
+            uint32_t wait_ms;
+            while ((wait_ms = uplink_rate_acquire()) > 0) {
+                vTaskDelay(pdMS_TO_TICKS(wait_ms));
             }
-            
-            // Forçar reset se travou
-            if (requisicao_em_curso) {
-                printf("HTTP: Timeout aguardando requisicao anterior, resetando...\n");
-                requisicao_em_curso = false;
+
+            // Aguardar um slot livre na tabela do uplink. Cada requisição tem o
+            // próprio timeout, então slots presos são liberados pelo uplink
+            while (!uplink_can_send()) {
+                vTaskDelay(pdMS_TO_TICKS(UPLINK_SLOT_WAIT_MS));
             }
 
-            if (wifi_connected) {
-                requisicao_em_curso = true;
-                
-                httpc_connection_t settings;
-                memset(&settings, 0, sizeof(settings));
-                settings.result_fn = http_client_callback;
-                settings.use_proxy = 0;
-
-                char uri[128];
-                snprintf(uri, sizeof(uri), 
-                    "/data?r=%d&g=%d&b=%d&c=%d&dist=%d",
-                    data.red, data.green, data.blue, data.clear, data.distance);
-
-                printf("HTTP: Enviando dist=%dmm...\n", data.distance);
-
-                err_t err = httpc_get_file(&server_addr, SERVER_PORT, uri, 
-                                          &settings, NULL, NULL, NULL);
-
-                if (err != ERR_OK) {
-                    requisicao_em_curso = false;
-                    if (err == -16) {
-                        printf("HTTP Erro -16: Requisicao em andamento (aguarde)\n");
-                    } else {
-                        printf("HTTP Erro: %d\n", (int)err);
-                    }
+            server_endpoint_t server;
+            int server_index = server_pool_pick(to_ms_since_boot(get_absolute_time()));
+            server_pool_get(server_index, &server);
+#if UPLINK_FORMAT_BINARY
+            err_t err = send_batch(&entry, base_seq, &server);
+#else
+            void *ctx = (void *)(uintptr_t)(sent_count + 1);
+            err_t err = send_sample(&data, &server, ctx);
+#endif
+            if (err != ERR_OK) {
+                server_pool_cancel(server_index);
+                uplink_rate_feedback(false, 0);
+#if UPLINK_FORMAT_BINARY
+                batch_window_result(entry.seq, false, false, 0, to_ms_since_boot(get_absolute_time()));
+#endif
+                if (err == ERR_INPROGRESS) {
+                    printf("HTTP Erro: tabela de requisicoes cheia\n");
+                } else if (err == ERR_MEM) {
+                    printf("HTTP Erro: pool do uplink esgotado\n");
+                } else {
+                    printf("HTTP Erro: %d\n", (int)err);
                 }
             }
-            
-            // Delay maior entre requisições
-            vTaskDelay(pdMS_TO_TICKS(3000));
+
+            if (++sent_count % 10 == 0) {
+                print_uplink_stats();
+            }
+#if UPLINK_FORMAT_BINARY
+            // Esvazia a janela de lotes (novos e retransmissões) na mesma janela de rádio
+            more = !radio_window_expired() &&
+                   batch_window_take(&entry, &base_seq, to_ms_since_boot(get_absolute_time()));
+#else
+            more = false;
+#endif
+        } while (more);
+
+        // Espera as respostas (ACK, controle) antes de voltar ao power-save
+        while (uplink_in_flight() > 0 && !radio_window_expired()) {
+            vTaskDelay(pdMS_TO_TICKS(UPLINK_SLOT_WAIT_MS));
         }
+        radio_window_close();
     }
 }
 
+// ==================== Display ====================
+static chart_t distance_chart;
+
+// Ícones de 7x8 (bit 0 em cima) para o estado do WiFi
+static const uint8_t icon_wifi_columns[] = { 0x02, 0x09, 0x05, 0x35, 0x05, 0x09, 0x02 };
+static const uint8_t icon_no_wifi_columns[] = { 0x41, 0x22, 0x14, 0x08, 0x14, 0x22, 0x41 };
+static const ui_icon_t icon_wifi = { icon_wifi_columns, sizeof(icon_wifi_columns) };
+static const ui_icon_t icon_no_wifi = { icon_no_wifi_columns, sizeof(icon_no_wifi_columns) };
+
+static ui_widget_t ui_distance;     // "1234 mm" em 2x
+static ui_widget_t ui_light;        // Canal clear do TCS34725
+static ui_widget_t ui_color;
+static ui_widget_t ui_wifi_icon;
+static ui_widget_t ui_wifi_label;
+static ui_widget_t *const ui_widgets[] = {
+    &ui_distance, &ui_light, &ui_color, &ui_wifi_icon, &ui_wifi_label,
+};
+
+static void display_ui_init(void) {
+    ui_value_init(&ui_distance, 0, 0, 2, 7, "%4ld mm", "---- mm");
+    ui_bar_init(&ui_light, 90, 17, 38, 6, UINT16_MAX);
+    ui_label_init(&ui_color, 0, 24, 1, 21, "Cor:");
+    ui_icon_init(&ui_wifi_icon, 0, 56, 8, &icon_no_wifi);
+    ui_label_init(&ui_wifi_label, 12, 56, 1, 19, "Sem WiFi");
+    chart_init(&distance_chart, 0, DISPLAY_CHART_Y, SSD1306_WIDTH, DISPLAY_CHART_HEIGHT,
+               DISPLAY_CHART_STEP_MM);
+}
+
+// Só os widgets cujo valor mudou são redesenhados; o gráfico grava uma coluna
+static void display_sample(const SensorData *data) {
+    ssd1306_t *canvas = display_begin();
+    if (!canvas) {
+        return;
+    }
+    bool valid = data->distance != 0xFFFF && data->distance < 2000;
+    ui_value_set(&ui_distance, data->distance, valid);
+    ui_bar_set(&ui_light, data->clear);
+    char line[UI_TEXT_MAX + 1];
+    snprintf(line, sizeof(line), "Cor: %s", sample_color_names[data->color_id]);
+    ui_label_set(&ui_color, line);
+    ui_icon_set(&ui_wifi_icon, wifi_connected ? &icon_wifi : &icon_no_wifi);
+    ui_label_set(&ui_wifi_label, wifi_connected ? "WiFi OK" : "Sem WiFi");
+
+    ui_draw(canvas, ui_widgets, sizeof(ui_widgets) / sizeof(ui_widgets[0]));
+    chart_push(&distance_chart, canvas, valid ? data->distance : CHART_NO_VALUE);
+    display_publish();
+}
+
 // ==================== TASK: Sensores ====================
 void sensor_task(void *pvParameters) {
     SensorData data;
@@ -339,6 +875,12 @@ void sensor_task(void *pvParameters) {
     gpio_set_function(I2C1_SCL, GPIO_FUNC_I2C);
     gpio_pull_up(I2C1_SDA);
     gpio_pull_up(I2C1_SCL);
+
+    // Display antes dos sensores, como no main.c; sem ele a coleta segue
+    display_ui_init();
+    if (!display_init(I2C0_PORT, DISPLAY_I2C_ADDR, i2c0_mutex)) {
+        printf("Sensor Task: Aviso - display nao iniciado\n");
+    }
     
     printf("Sensor Task: Inicializando sensores...\n");
     tcs34725_init();
@@ -364,8 +906,10 @@ void sensor_task(void *pvParameters) {
             led_set_color(false, false, false);
         }
         
-        // Detectar nome da cor
-        const char* color_name = get_color_name(data.red, data.green, data.blue);
+        // Detectar cor
+        data.color_id = get_color_id(data.red, data.green, data.blue);
+        data.timestamp_ms = device_clock_now_ms();
+        const char* color_name = sample_color_names[data.color_id];
         
         // Exibir
         printf("+-----------------------------------------------------------+\n");
@@ -379,10 +923,107 @@ void sensor_task(void *pvParameters) {
         }
         printf("+-----------------------------------------------------------+\n");
         
-        // Enviar para fila HTTP
-        xQueueOverwrite(xQueueSensorData, &data);
-        
-        vTaskDelay(pdMS_TO_TICKS(1500));
+        sample_ring_push(&data);
+        display_sample(&data);
+
+        // Enviar para fila HTTP (descarta a amostra mais antiga se cheia);
+        // com delta do servidor, só leituras que mudaram (ou o heartbeat)
+        if (sampling_ctl_should_report(&data) &&
+            xQueueSend(xQueueSensorData, &data, 0) != pdTRUE) {
+            SensorData dropped;
+            xQueueReceive(xQueueSensorData, &dropped, 0);
+            xQueueSend(xQueueSensorData, &data, 0);
+        }
+
+        // Período definido pelo servidor; a notificação encurta a espera
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sampling_ctl_period_ms()));
+    }
+}
+
+// ==================== WiFi: Rejoin Rápido ====================
+static int wifi_wait_link_up(uint32_t timeout_ms) {
+    absolute_time_t deadline = make_timeout_time_ms(timeout_ms);
+    while (!time_reached(deadline)) {
+        int status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+        if (status == CYW43_LINK_UP) {
+            return 0;
+        }
+        if (status < 0) {
+            return status;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return PICO_ERROR_TIMEOUT;
+}
+
+// Join direcionado ao BSSID/canal em cache, com o IP do último lease
+// configurado estaticamente (sem varredura e sem DHCP)
+static int wifi_connect_fast(const wifi_cache_t *cache) {
+    struct netif *netif = &cyw43_state.netif[CYW43_ITF_STA];
+    ip4_addr_t ip, netmask, gateway;
+    ip.addr = cache->ip;
+    netmask.addr = cache->netmask;
+    gateway.addr = cache->gateway;
+
+    cyw43_arch_lwip_begin();
+    dhcp_stop(netif);
+    netif_set_addr(netif, &ip, &netmask, &gateway);
+    cyw43_arch_lwip_end();
+
+    int err = cyw43_wifi_join(&cyw43_state, strlen(WIFI_SSID), (const uint8_t *)WIFI_SSID,
+                              strlen(WIFI_PASSWORD), (const uint8_t *)WIFI_PASSWORD,
+                              CYW43_AUTH_WPA2_AES_PSK, cache->bssid, cache->channel);
+    if (err == 0) {
+        err = wifi_wait_link_up(WIFI_FAST_JOIN_TIMEOUT_MS);
+    }
+    if (err != 0) {
+        // Desfaz o IP estático e devolve a interface ao DHCP
+        cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+        cyw43_arch_lwip_begin();
+        netif_set_addr(netif, IP4_ADDR_ANY4, IP4_ADDR_ANY4, IP4_ADDR_ANY4);
+        dhcp_start(netif);
+        cyw43_arch_lwip_end();
+    }
+    return err;
+}
+
+// SNTP em modo poll; cada resposta chama device_clock_sntp_set() (lwipopts.h)
+static void sntp_start(void) {
+    ip_addr_t addr;
+    ip4addr_aton(SNTP_SERVER_IP, &addr);
+
+    cyw43_arch_lwip_begin();
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_setserver(0, &addr);
+    sntp_init();
+    cyw43_arch_lwip_end();
+    printf("SNTP: servidor %s porta %d\n", SNTP_SERVER_IP, SNTP_PORT);
+}
+
+// Salva canal, BSSID e configuração IP da conexão atual para o próximo boot
+static void wifi_save_cache(void) {
+    struct netif *netif = &cyw43_state.netif[CYW43_ITF_STA];
+    wifi_cache_t cache;
+    uint8_t channel_info[12] = {0};
+    memset(&cache, 0, sizeof(cache));
+
+    if (cyw43_wifi_get_bssid(&cyw43_state, cache.bssid) != 0) {
+        return;
+    }
+    if (cyw43_ioctl(&cyw43_state, CYW43_IOCTL_GET_CHANNEL, sizeof(channel_info),
+                    channel_info, CYW43_ITF_STA) != 0) {
+        return;
+    }
+    cache.channel = channel_info[0];  // channel_info_t.hw_channel (little-endian)
+
+    cyw43_arch_lwip_begin();
+    cache.ip = netif_ip4_addr(netif)->addr;
+    cache.netmask = netif_ip4_netmask(netif)->addr;
+    cache.gateway = netif_ip4_gw(netif)->addr;
+    cyw43_arch_lwip_end();
+
+    if (!wifi_cache_store(&cache, WIFI_SSID)) {
+        printf("WiFi: Aviso - falha ao gravar cache na flash\n");
     }
 }
 
@@ -390,29 +1031,63 @@ void sensor_task(void *pvParameters) {
 void wifi_task(void *pvParameters) {
     printf("WiFi Task: Inicializando...\n");
     
-    if (cyw43_arch_init()) {
+    int init_error = cyw43_arch_init();
+    // cyw43_arch_init() cria as tasks do cyw43 e do lwIP: elas e as idle
+    // tasks ganham afinidade aqui, e a medição por núcleo começa
+    cpu_cores_pin_unpinned(CPU_CORE_NET);
+    if (init_error) {
         printf("WiFi: ERRO ao inicializar!\n");
         // Continua sem WiFi
         while(true) {
             vTaskDelay(pdMS_TO_TICKS(10000));
+            cpu_cores_update();
         }
     }
     
     cyw43_arch_enable_sta_mode();
-    printf("WiFi: Conectando a '%s'...\n", WIFI_SSID);
-    
-    int result = cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, 
-                                                     CYW43_AUTH_WPA2_AES_PSK, 30000);
+
+    uint64_t t_start = time_us_64();
+    int result = -1;
+    wifi_cache_t cache;
+
+    if (wifi_cache_load(&cache, WIFI_SSID)) {
+        printf("WiFi: Rejoin rapido em '%s' (canal %d, BSSID %02X:%02X:%02X:%02X:%02X:%02X)...\n",
+               WIFI_SSID, cache.channel, cache.bssid[0], cache.bssid[1], cache.bssid[2],
+               cache.bssid[3], cache.bssid[4], cache.bssid[5]);
+        result = wifi_connect_fast(&cache);
+        if (result == 0) {
+            wifi_fast_path = true;
+        } else {
+            printf("WiFi: Rejoin rapido falhou (erro %d), usando varredura completa\n", result);
+            wifi_cache_invalidate();
+        }
+    }
+
+    if (result != 0) {
+        printf("WiFi: Conectando a '%s'...\n", WIFI_SSID);
+        result = cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, 
+                                                    CYW43_AUTH_WPA2_AES_PSK, WIFI_FULL_JOIN_TIMEOUT_MS);
+    }
     
     if (result == 0) {
-        printf("WiFi: CONECTADO!\n");
+        wifi_connect_ms = (uint32_t)((time_us_64() - t_start) / 1000);
+        printf("WiFi: CONECTADO em %lu ms (%s)\n", (unsigned long)wifi_connect_ms,
+               wifi_fast_path ? "rejoin rapido" : "varredura + DHCP");
         wifi_connected = true;
+        wifi_save_cache();
+        sntp_start();
+
+        device_httpd_set_wifi_stats(wifi_connect_ms, wifi_fast_path);
+#if UPLINK_LEGACY_BENCH == 0
+        // Com a comparação do uplink, o http_task sobe o httpd depois dela
+        start_httpd();
+#endif
     } else {
         printf("WiFi: Falha na conexao (erro %d)\n", result);
         printf("WiFi: Continuando SEM WiFi (apenas leitura sensores)\n");
     }
     
-    // LED interno pisca
+    // LED interno pisca; cada volta fecha uma janela da ocupação por núcleo
     while (true) {
         if (wifi_connected) {
             cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1);
@@ -422,6 +1097,7 @@ void wifi_task(void *pvParameters) {
         } else {
             vTaskDelay(pdMS_TO_TICKS(5000));
         }
+        cpu_cores_update();
     }
 }
 
@@ -459,13 +1135,17 @@ int main() {
     printf("LED: OK\n\n");
     
     // Criar fila
-    xQueueSensorData = xQueueCreate(1, sizeof(SensorData));
+    sampling_ctl_init(UPLINK_BATCH_SIZE, UPLINK_BATCH_SIZE);
+    xQueueSensorData = xQueueCreate(UPLINK_BATCH_SIZE, sizeof(SensorData));
+    i2c0_mutex = xSemaphoreCreateMutex();
     
     printf("Criando tasks FreeRTOS...\n");
-    // Tasks com prioridades ajustadas
-    xTaskCreate(sensor_task, "Sensores", 2048, NULL, 3, NULL);  // Maior prioridade
-    xTaskCreate(wifi_task, "WiFi", 1024, NULL, 1, NULL);        // Menor prioridade
-    xTaskCreate(http_task, "HTTP", 4096, NULL, 2, NULL);        // Média prioridade
+    // Tasks com prioridades ajustadas; sensores (e o display que ela cria) no
+    // núcleo 1, rede e uplink no núcleo 0
+    cpu_cores_create_task(sensor_task, "Sensores", 2048, NULL, 3, CPU_CORE_IO,
+                          &sensor_task_handle);                                 // Maior prioridade
+    cpu_cores_create_task(wifi_task, "WiFi", 1024, NULL, 1, CPU_CORE_NET, NULL);   // Menor prioridade
+    cpu_cores_create_task(http_task, "HTTP", 4096, NULL, 2, CPU_CORE_NET, NULL);   // Média prioridade
     
     printf("Iniciando scheduler FreeRTOS...\n\n");
     vTaskStartScheduler();
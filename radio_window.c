@@ -0,0 +1,94 @@
+/**
+ * Janelas de rádio alinhadas ao uplink em lotes
+ *
+ * Fora das janelas o CYW43 fica em PM1; o http_task abre a janela quando há
+ * lote a enviar, esvazia a fila de envio, espera as respostas e fecha. O
+ * tempo com janela aberta dá o duty cycle do rádio; a idade das amostras no
+ * envio dá a latência que o agrupamento adiciona.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "pico/cyw43_arch.h"
+
+#include "radio_window.h"
+
+static radio_window_stats_t stats;
+static bool is_open = false;
+static uint32_t opened_ms = 0;
+static uint32_t init_ms = 0;
+
+static uint32_t now_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static void radio_set_pm(uint32_t pm) {
+    if (!stats.enabled) {
+        return;
+    }
+    if (cyw43_wifi_pm(&cyw43_state, pm) != 0) {
+        stats.pm_errors++;
+    }
+}
+
+void radio_window_init(bool enabled) {
+    stats = (radio_window_stats_t){ .enabled = enabled };
+    is_open = false;
+    init_ms = now_ms();
+    radio_set_pm(RADIO_WINDOW_PM_IDLE);
+}
+
+void radio_window_open(void) {
+    if (is_open) {
+        return;
+    }
+    radio_set_pm(RADIO_WINDOW_PM_ACTIVE);
+    taskENTER_CRITICAL();
+    is_open = true;
+    opened_ms = now_ms();
+    stats.windows++;
+    taskEXIT_CRITICAL();
+}
+
+bool radio_window_expired(void) {
+    return is_open && now_ms() - opened_ms >= RADIO_WINDOW_MAX_MS;
+}
+
+void radio_window_close(void) {
+    if (!is_open) {
+        return;
+    }
+    radio_set_pm(RADIO_WINDOW_PM_IDLE);
+    taskENTER_CRITICAL();
+    is_open = false;
+    stats.active_ms += now_ms() - opened_ms;
+    taskEXIT_CRITICAL();
+}
+
+void radio_window_note_sample(uint32_t latency_ms) {
+    taskENTER_CRITICAL();
+    stats.samples++;
+    stats.latency_sum_ms += latency_ms;
+    if (latency_ms > stats.latency_max_ms) {
+        stats.latency_max_ms = latency_ms;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void radio_window_get_stats(radio_window_stats_t *out) {
+    uint32_t now = now_ms();
+
+    taskENTER_CRITICAL();
+    *out = stats;
+    // Janela aberta agora também conta como tempo ativo
+    if (is_open) {
+        out->active_ms += now - opened_ms;
+    }
+    taskEXIT_CRITICAL();
+    out->tracked_ms = now - init_ms;
+    if (!out->enabled) {
+        out->duty_permille = 1000;
+    } else if (out->tracked_ms) {
+        out->duty_permille = (uint32_t)(out->active_ms * 1000 / out->tracked_ms);
+    }
+}
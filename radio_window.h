@@ -0,0 +1,43 @@
+#ifndef RADIO_WINDOW_H
+#define RADIO_WINDOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Modos de energia do CYW43 dentro e fora das janelas de uplink. PM1 é o
+// modo mais econômico: o rádio dorme e só acorda nos beacons DTIM
+// (li_dtim_period), ao custo de latência para tráfego de entrada (/metrics,
+// SNTP) entre janelas
+#define RADIO_WINDOW_PM_ACTIVE      CYW43_PERFORMANCE_PM
+#define RADIO_WINDOW_PM_IDLE        cyw43_pm_value(CYW43_PM1_POWERSAVE_MODE, 200, 1, 3, 10)
+// Janela máxima: depois disso o rádio volta ao power-save mesmo com
+// requisições pendentes (elas terminam, só que mais devagar)
+#define RADIO_WINDOW_MAX_MS         10000
+
+typedef struct {
+	bool enabled;               // false: rádio sempre no modo padrão
+	uint32_t windows;
+	uint32_t pm_errors;         // Falhas de cyw43_wifi_pm()
+	uint64_t active_ms;         // Tempo total com janela aberta
+	uint64_t tracked_ms;        // Tempo desde radio_window_init()
+	uint32_t duty_permille;     // active_ms / tracked_ms
+	uint32_t samples;           // Amostras enviadas (primeiro envio)
+	uint64_t latency_sum_ms;    // Captura -> envio, somado por amostra
+	uint32_t latency_max_ms;
+} radio_window_stats_t;
+
+// enabled = false mantém o power-save padrão do driver e só mede
+void radio_window_init(bool enabled);
+
+// Abre a janela (rádio em desempenho); idempotente
+void radio_window_open(void);
+bool radio_window_expired(void);
+// Fecha a janela e volta ao power-save profundo
+void radio_window_close(void);
+
+// Latência adicionada pelo agrupamento/janela para uma amostra enviada agora
+void radio_window_note_sample(uint32_t latency_ms);
+
+void radio_window_get_stats(radio_window_stats_t *stats);
+
+#endif // RADIO_WINDOW_H
@@ -0,0 +1,81 @@
+/**
+ * Controle de taxa do uplink (token bucket + AIMD)
+ *
+ * Substitui os atrasos fixos entre envios: o bucket limita a taxa
+ * sustentada e a rajada, e a taxa sobe devagar enquanto o servidor responde
+ * dentro do alvo de latência e cai pela metade quando ele dá sinais de
+ * sobrecarga. Não usa RTOS - quem chama cuida da exclusão mútua.
+ */
+
+#include "rate_ctl.h"
+
+void rate_ctl_init(rate_ctl_t *rc, uint32_t rate_mrps, uint32_t min_mrps, uint32_t max_mrps,
+                   uint32_t burst, uint32_t latency_target_ms, uint32_t now_ms) {
+    *rc = (rate_ctl_t){0};
+    rc->min_mrps = min_mrps ? min_mrps : 1;
+    rc->max_mrps = max_mrps < rc->min_mrps ? rc->min_mrps : max_mrps;
+    rc->rate_mrps = rate_mrps < rc->min_mrps ? rc->min_mrps
+                  : (rate_mrps > rc->max_mrps ? rc->max_mrps : rate_mrps);
+    // Passo aditivo: ~1/20 da faixa, para ir do mínimo ao máximo em 20 sucessos
+    rc->increase_mrps = (rc->max_mrps - rc->min_mrps) / 20 + 1;
+    rc->burst = burst ? burst : 1;
+    rc->latency_target_ms = latency_target_ms;
+    rc->latency_ewma_ms = latency_target_ms / 2;
+    // Começa com um token: o primeiro envio não espera
+    rc->tokens = RATE_CTL_TOKEN;
+    rc->last_refill_ms = now_ms;
+    rc->last_decrease_ms = now_ms - latency_target_ms;
+}
+
+static void rate_ctl_refill(rate_ctl_t *rc, uint32_t now_ms) {
+    uint64_t cap = (uint64_t)rc->burst * RATE_CTL_TOKEN;
+    uint32_t elapsed = now_ms - rc->last_refill_ms;
+
+    rc->last_refill_ms = now_ms;
+    // mrps x ms = 1e-6 token
+    rc->tokens += (uint64_t)rc->rate_mrps * elapsed;
+    if (rc->tokens > cap) {
+        rc->tokens = cap;
+    }
+}
+
+uint32_t rate_ctl_acquire(rate_ctl_t *rc, uint32_t now_ms) {
+    rate_ctl_refill(rc, now_ms);
+    if (rc->tokens >= RATE_CTL_TOKEN) {
+        rc->tokens -= RATE_CTL_TOKEN;
+        rc->granted++;
+        return 0;
+    }
+    uint64_t missing = RATE_CTL_TOKEN - rc->tokens;
+    uint32_t wait_ms = (uint32_t)((missing + rc->rate_mrps - 1) / rc->rate_mrps);
+    rc->throttled_ms += wait_ms;
+    return wait_ms;
+}
+
+void rate_ctl_on_result(rate_ctl_t *rc, bool ok, uint32_t latency_ms, uint32_t now_ms) {
+    if (ok) {
+        int32_t ewma = (int32_t)rc->latency_ewma_ms;
+        rc->latency_ewma_ms = (uint32_t)(ewma + ((int32_t)latency_ms - ewma) / 8);
+    }
+
+    bool congested = !ok || latency_ms > rc->latency_target_ms;
+    if (!congested) {
+        if (rc->rate_mrps < rc->max_mrps) {
+            uint32_t next = rc->rate_mrps + rc->increase_mrps;
+            rc->rate_mrps = next > rc->max_mrps ? rc->max_mrps : next;
+            rc->increases++;
+        }
+        return;
+    }
+
+    if (now_ms - rc->last_decrease_ms < rc->latency_target_ms) {
+        return;
+    }
+    rc->last_decrease_ms = now_ms;
+    rc->rate_mrps = rc->rate_mrps / 2 < rc->min_mrps ? rc->min_mrps : rc->rate_mrps / 2;
+    // Descarta a rajada acumulada: ela foi medida com a taxa antiga
+    if (rc->tokens > RATE_CTL_TOKEN) {
+        rc->tokens = RATE_CTL_TOKEN;
+    }
+    rc->decreases++;
+}
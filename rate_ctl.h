@@ -0,0 +1,41 @@
+#ifndef RATE_CTL_H
+#define RATE_CTL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Taxas em mili-requisições por segundo (333 = uma a cada 3 s)
+#define RATE_CTL_TOKEN          1000000u    // Unidades internas por token
+
+// Token bucket com adaptação AIMD: cada resposta rápida soma increase_mrps
+// à taxa sustentada; erro, timeout ou latência acima do alvo dividem a taxa
+// por 2 (no máximo uma vez a cada latency_target_ms, para que uma rajada de
+// falhas da mesma janela conte como um único evento de congestionamento)
+typedef struct {
+	uint32_t rate_mrps;             // Taxa sustentada atual
+	uint32_t min_mrps;
+	uint32_t max_mrps;
+	uint32_t increase_mrps;         // Passo aditivo por sucesso
+	uint32_t burst;                 // Tokens acumuláveis (requisições)
+	uint32_t latency_target_ms;
+	uint64_t tokens;                // Em unidades de 1/RATE_CTL_TOKEN
+	uint32_t last_refill_ms;
+	uint32_t last_decrease_ms;
+	uint32_t latency_ewma_ms;       // Média móvel (alfa = 1/8)
+	// Contadores
+	uint32_t granted;
+	uint32_t throttled_ms;          // Tempo total de espera imposto
+	uint32_t increases;
+	uint32_t decreases;
+} rate_ctl_t;
+
+void rate_ctl_init(rate_ctl_t *rc, uint32_t rate_mrps, uint32_t min_mrps, uint32_t max_mrps,
+                   uint32_t burst, uint32_t latency_target_ms, uint32_t now_ms);
+
+// Consome um token e retorna 0, ou retorna quantos ms faltam para o próximo
+uint32_t rate_ctl_acquire(rate_ctl_t *rc, uint32_t now_ms);
+
+// Alimenta o AIMD com o resultado de uma requisição
+void rate_ctl_on_result(rate_ctl_t *rc, bool ok, uint32_t latency_ms, uint32_t now_ms);
+
+#endif // RATE_CTL_H
@@ -0,0 +1,177 @@
+/**
+ * Codificação binária compacta de lotes de amostras
+ *
+ * Timestamps em delta (varint) e canais em delta zigzag (varint) em relação
+ * à amostra anterior: leituras estáveis ocupam ~1 byte por canal em vez dos
+ * ~60 bytes da query string ASCII.
+ */
+
+#include <string.h>
+
+#include "sample_codec.h"
+
+const char *const sample_color_names[SAMPLE_COLOR_COUNT] = {
+    "INDEFINIDO", "PRETO", "BRANCO", "VERMELHO", "VERDE", "AZUL",
+    "AMARELO", "CIANO", "MAGENTA", "LARANJA", "CINZA", "MARROM",
+};
+
+// ==================== Codificação ====================
+static size_t put_varint(uint64_t value, sample_codec_put_fn put, void *ctx) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        put(ctx, (uint8_t)(value | 0x80));
+        value >>= 7;
+        n++;
+    }
+    put(ctx, (uint8_t)value);
+    return n + 1;
+}
+
+static size_t put_zigzag(int32_t value, sample_codec_put_fn put, void *ctx) {
+    return put_varint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31), put, ctx);
+}
+
+size_t sample_codec_encode(const sample_batch_header_t *header, const SensorData *samples,
+                           sample_codec_put_fn put, void *ctx) {
+    size_t len = 0;
+    size_t count = header->count;
+    uint64_t prev_ts = count ? samples[0].timestamp_ms : 0;
+    SensorData prev;
+    memset(&prev, 0, sizeof(prev));
+
+    put(ctx, SAMPLE_CODEC_VERSION);
+    for (int i = 0; i < SAMPLE_CODEC_DEVICE_ID_LEN; i++) {
+        put(ctx, header->device_id[i]);
+    }
+    for (int i = 0; i < 4; i++) {
+        put(ctx, (uint8_t)(header->stream_id >> (8 * i)));
+    }
+    len += 1 + SAMPLE_CODEC_DEVICE_ID_LEN + 4;
+    len += put_varint(header->seq, put, ctx);
+    len += put_varint(header->base_seq, put, ctx);
+    len += put_varint(count, put, ctx);
+    len += put_varint(prev_ts, put, ctx);
+
+    for (size_t i = 0; i < count; i++) {
+        const SensorData *s = &samples[i];
+        // Timestamps fora de ordem são gravados como delta 0
+        uint64_t dt = s->timestamp_ms > prev_ts ? s->timestamp_ms - prev_ts : 0;
+        len += put_varint(dt, put, ctx);
+        len += put_zigzag((int32_t)s->red - prev.red, put, ctx);
+        len += put_zigzag((int32_t)s->green - prev.green, put, ctx);
+        len += put_zigzag((int32_t)s->blue - prev.blue, put, ctx);
+        len += put_zigzag((int32_t)s->clear - prev.clear, put, ctx);
+        len += put_zigzag((int32_t)s->distance - prev.distance, put, ctx);
+        put(ctx, s->color_id);
+        len++;
+        prev_ts += dt;
+        prev = *s;
+    }
+    return len;
+}
+
+// ==================== Decodificação ====================
+typedef struct {
+    const uint8_t *buf;
+    size_t len;
+    size_t pos;
+    bool error;
+} codec_reader_t;
+
+static uint64_t get_varint(codec_reader_t *r) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (r->pos >= r->len) {
+            break;
+        }
+        uint8_t byte = r->buf[r->pos++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    r->error = true;
+    return 0;
+}
+
+static int32_t get_zigzag(codec_reader_t *r) {
+    uint64_t raw = get_varint(r);
+    if (raw > UINT32_MAX) {
+        r->error = true;
+        return 0;
+    }
+    return (int32_t)((uint32_t)raw >> 1) ^ -(int32_t)(raw & 1);
+}
+
+static uint16_t apply_delta(codec_reader_t *r, uint16_t prev) {
+    int32_t value = (int32_t)prev + get_zigzag(r);
+    if (value < 0 || value > UINT16_MAX) {
+        r->error = true;
+        return 0;
+    }
+    return (uint16_t)value;
+}
+
+int sample_codec_decode(const uint8_t *buf, size_t len, sample_batch_header_t *header,
+                        SensorData *samples, size_t max_samples) {
+    codec_reader_t r = { buf, len, 0, false };
+
+    if (len < 1 + SAMPLE_CODEC_DEVICE_ID_LEN ||
+        (buf[0] != SAMPLE_CODEC_VERSION && buf[0] != SAMPLE_CODEC_VERSION_V1)) {
+        return -1;
+    }
+    memset(header, 0, sizeof(*header));
+    header->version = buf[0];
+    memcpy(header->device_id, &buf[1], SAMPLE_CODEC_DEVICE_ID_LEN);
+    r.pos = 1 + SAMPLE_CODEC_DEVICE_ID_LEN;
+
+    if (header->version >= 2) {
+        if (r.pos + 4 > len) {
+            return -1;
+        }
+        for (int i = 0; i < 4; i++) {
+            header->stream_id |= (uint32_t)buf[r.pos++] << (8 * i);
+        }
+        uint64_t seq = get_varint(&r);
+        uint64_t base_seq = get_varint(&r);
+        if (seq > UINT32_MAX || base_seq > seq) {
+            return -1;
+        }
+        header->seq = (uint32_t)seq;
+        header->base_seq = (uint32_t)base_seq;
+    }
+
+    uint64_t count = get_varint(&r);
+    header->base_timestamp_ms = get_varint(&r);
+    if (r.error || count > max_samples) {
+        return -1;
+    }
+    header->count = (uint32_t)count;
+
+    uint64_t ts = header->base_timestamp_ms;
+    SensorData prev;
+    memset(&prev, 0, sizeof(prev));
+
+    for (uint32_t i = 0; i < header->count; i++) {
+        SensorData *s = &samples[i];
+        ts += get_varint(&r);
+        s->timestamp_ms = ts;
+        s->red = apply_delta(&r, prev.red);
+        s->green = apply_delta(&r, prev.green);
+        s->blue = apply_delta(&r, prev.blue);
+        s->clear = apply_delta(&r, prev.clear);
+        s->distance = apply_delta(&r, prev.distance);
+        if (r.pos >= r.len) {
+            r.error = true;
+        } else {
+            s->color_id = r.buf[r.pos++];
+        }
+        if (r.error || s->color_id >= SAMPLE_COLOR_COUNT) {
+            return -1;
+        }
+        prev = *s;
+    }
+
+    // Bytes sobrando indicam lote corrompido
+    return r.pos == r.len ? (int)header->count : -1;
+}
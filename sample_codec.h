@@ -0,0 +1,83 @@
+#ifndef SAMPLE_CODEC_H
+#define SAMPLE_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Formato binário de lotes de amostras (POST /batch, application/octet-stream)
+//
+//   u8      versão (SAMPLE_CODEC_VERSION)
+//   u8[8]   ID da placa
+//   u32     ID do stream (little-endian, sorteado a cada boot)       [v2]
+//   varint  número de sequência do lote no stream                   [v2]
+//   varint  menor sequência ainda retida pelo dispositivo (as       [v2]
+//           anteriores não serão retransmitidas)
+//   varint  número de amostras
+//   varint  timestamp base (ms UTC; abaixo de 1e12 = ms desde o boot, sem SNTP)
+//   por amostra:
+//     varint  delta de timestamp (ms) em relação à amostra anterior/base
+//     zigzag  deltas de R, G, B, Clear e distância em relação à amostra anterior
+//     u8      ID da cor (sample_color_t)
+//
+// O decodificador aceita v1 (sem stream/sequência) e v2.
+#define SAMPLE_CODEC_VERSION    2
+#define SAMPLE_CODEC_VERSION_V1 1
+#define SAMPLE_CODEC_DEVICE_ID_LEN 8
+
+// Pior caso por amostra: 10 (u64) + 5 x 3 (u16 zigzag) + 1
+#define SAMPLE_CODEC_MAX_SAMPLE_LEN 26
+#define SAMPLE_CODEC_MAX_HEADER_LEN (1 + SAMPLE_CODEC_DEVICE_ID_LEN + 4 + 5 + 5 + 5 + 10)
+
+// IDs de cor no fio - mesma ordem de COLOR_NAMES em server.py
+typedef enum {
+	SAMPLE_COLOR_INDEFINIDO = 0,
+	SAMPLE_COLOR_PRETO,
+	SAMPLE_COLOR_BRANCO,
+	SAMPLE_COLOR_VERMELHO,
+	SAMPLE_COLOR_VERDE,
+	SAMPLE_COLOR_AZUL,
+	SAMPLE_COLOR_AMARELO,
+	SAMPLE_COLOR_CIANO,
+	SAMPLE_COLOR_MAGENTA,
+	SAMPLE_COLOR_LARANJA,
+	SAMPLE_COLOR_CINZA,
+	SAMPLE_COLOR_MARROM,
+	SAMPLE_COLOR_COUNT
+} sample_color_t;
+
+typedef struct {
+	uint16_t red;
+	uint16_t green;
+	uint16_t blue;
+	uint16_t clear;
+	uint16_t distance;
+	uint8_t color_id;
+	uint64_t timestamp_ms;
+} SensorData;
+
+typedef struct {
+	uint8_t version;
+	uint8_t device_id[SAMPLE_CODEC_DEVICE_ID_LEN];
+	uint32_t stream_id;         // v1: 0
+	uint32_t seq;               // v1: 0
+	uint32_t base_seq;          // v1: 0
+	uint32_t count;
+	uint64_t base_timestamp_ms;
+} sample_batch_header_t;
+
+// Destino dos bytes codificados (ex.: pbufs do uplink)
+typedef void (*sample_codec_put_fn)(void *ctx, uint8_t byte);
+
+extern const char *const sample_color_names[SAMPLE_COLOR_COUNT];
+
+// Codifica em v2; header->count amostras, header->version e base_timestamp_ms
+// são ignorados (derivados das amostras)
+size_t sample_codec_encode(const sample_batch_header_t *header, const SensorData *samples,
+                           sample_codec_put_fn put, void *ctx);
+
+// Retorna o número de amostras decodificadas ou -1 se o lote for inválido
+int sample_codec_decode(const uint8_t *buf, size_t len, sample_batch_header_t *header,
+                        SensorData *samples, size_t max_samples);
+
+#endif // SAMPLE_CODEC_H
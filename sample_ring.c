@@ -0,0 +1,39 @@
+/**
+ * Anel das últimas amostras
+ *
+ * Escrito pela task de sensores e lido pelo httpd (thread do lwIP); o acesso
+ * é protegido por seção crítica curta do FreeRTOS.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sample_ring.h"
+
+static SensorData ring[SAMPLE_RING_SIZE];
+static uint32_t ring_total = 0;
+
+void sample_ring_push(const SensorData *sample) {
+    taskENTER_CRITICAL();
+    ring[ring_total % SAMPLE_RING_SIZE] = *sample;
+    ring_total++;
+    taskEXIT_CRITICAL();
+}
+
+size_t sample_ring_latest(SensorData *out, size_t max) {
+    taskENTER_CRITICAL();
+    size_t count = ring_total < SAMPLE_RING_SIZE ? ring_total : SAMPLE_RING_SIZE;
+    if (count > max) {
+        count = max;
+    }
+    uint32_t first = ring_total - count;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = ring[(first + i) % SAMPLE_RING_SIZE];
+    }
+    taskEXIT_CRITICAL();
+    return count;
+}
+
+uint32_t sample_ring_total(void) {
+    return ring_total;
+}
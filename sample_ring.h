@@ -0,0 +1,16 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include "sample_codec.h"
+
+// Últimas amostras lidas, compartilhadas entre a task de sensores e o httpd
+#define SAMPLE_RING_SIZE        32
+
+void sample_ring_push(const SensorData *sample);
+
+// Copia as 'max' amostras mais recentes (da mais antiga para a mais nova)
+size_t sample_ring_latest(SensorData *out, size_t max);
+
+uint32_t sample_ring_total(void);
+
+#endif // SAMPLE_RING_H
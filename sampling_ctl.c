@@ -0,0 +1,103 @@
+/**
+ * Amostragem controlada pelo servidor
+ *
+ * O servidor devolve período, tamanho de lote e delta de report-on-change em
+ * cada resposta; os valores são aplicados aqui (contexto do lwIP) e lidos
+ * pelas tarefas de sensores e HTTP a cada iteração.
+ */
+
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sampling_ctl.h"
+
+static sampling_ctl_t ctl;
+static uint32_t batch_limit = 1;
+
+// Estado do report-on-change (só a tarefa de sensores acessa)
+static SensorData last_reported;
+static bool has_reported = false;
+static uint32_t periods_since_report = 0;
+
+static uint32_t clamp(uint32_t value, uint32_t min, uint32_t max) {
+    return value < min ? min : (value > max ? max : value);
+}
+
+void sampling_ctl_init(uint32_t batch_size, uint32_t batch_max) {
+    batch_limit = batch_max ? batch_max : 1;
+    ctl.period_ms = SAMPLING_PERIOD_DEFAULT_MS;
+    ctl.batch_size = clamp(batch_size, 1, batch_limit);
+    ctl.delta = 0;
+}
+
+bool sampling_ctl_set(uint32_t period_ms, uint32_t batch_size, uint32_t delta) {
+    bool changed = false;
+
+    taskENTER_CRITICAL();
+    if (period_ms != SAMPLING_KEEP) {
+        period_ms = clamp(period_ms, SAMPLING_PERIOD_MIN_MS, SAMPLING_PERIOD_MAX_MS);
+        changed |= period_ms != ctl.period_ms;
+        ctl.period_ms = period_ms;
+    }
+    if (batch_size != SAMPLING_KEEP) {
+        batch_size = clamp(batch_size, 1, batch_limit);
+        changed |= batch_size != ctl.batch_size;
+        ctl.batch_size = batch_size;
+    }
+    if (delta != SAMPLING_KEEP) {
+        delta = clamp(delta, 0, UINT16_MAX);
+        changed |= delta != ctl.delta;
+        ctl.delta = delta;
+    }
+    if (changed) {
+        ctl.updates++;
+    }
+    taskEXIT_CRITICAL();
+    return changed;
+}
+
+uint32_t sampling_ctl_period_ms(void) {
+    return ctl.period_ms;
+}
+
+uint32_t sampling_ctl_batch_size(void) {
+    return ctl.batch_size;
+}
+
+static bool channel_changed(uint16_t a, uint16_t b, uint32_t delta) {
+    return (uint32_t)abs((int32_t)a - (int32_t)b) >= delta;
+}
+
+bool sampling_ctl_should_report(const SensorData *s) {
+    uint32_t delta = ctl.delta;
+    bool report = !has_reported || delta == 0 ||
+                  ++periods_since_report >= SAMPLING_HEARTBEAT_PERIODS ||
+                  s->color_id != last_reported.color_id ||
+                  channel_changed(s->distance, last_reported.distance, delta) ||
+                  channel_changed(s->red, last_reported.red, delta) ||
+                  channel_changed(s->green, last_reported.green, delta) ||
+                  channel_changed(s->blue, last_reported.blue, delta) ||
+                  channel_changed(s->clear, last_reported.clear, delta);
+
+    taskENTER_CRITICAL();
+    if (report) {
+        ctl.reported++;
+    } else {
+        ctl.suppressed++;
+    }
+    taskEXIT_CRITICAL();
+
+    if (report) {
+        last_reported = *s;
+        has_reported = true;
+        periods_since_report = 0;
+    }
+    return report;
+}
+
+void sampling_ctl_get(sampling_ctl_t *out) {
+    taskENTER_CRITICAL();
+    *out = ctl;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,42 @@
+#ifndef SAMPLING_CTL_H
+#define SAMPLING_CTL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sample_codec.h"
+
+// Parâmetros de amostragem ajustáveis pelo servidor (resposta do uplink:
+// period_ms=, batch=, delta=) sem regravar o firmware
+#define SAMPLING_PERIOD_DEFAULT_MS  1500
+#define SAMPLING_PERIOD_MIN_MS      200
+#define SAMPLING_PERIOD_MAX_MS      60000
+// Com delta > 0, envia ao menos uma leitura a cada N períodos (sinal de vida)
+#define SAMPLING_HEARTBEAT_PERIODS  10
+
+typedef struct {
+	uint32_t period_ms;     // Intervalo entre leituras
+	uint32_t batch_size;    // Amostras por lote (1..batch_max)
+	uint32_t delta;         // Mudança mínima em algum canal/distância para reportar; 0 = tudo
+	uint32_t updates;       // Ajustes aplicados pelo servidor
+	uint32_t reported;
+	uint32_t suppressed;    // Leituras não enviadas por não mudarem
+} sampling_ctl_t;
+
+// Valor ausente na resposta: mantém o atual
+#define SAMPLING_KEEP               UINT32_MAX
+
+void sampling_ctl_init(uint32_t batch_size, uint32_t batch_max);
+
+// Aplica novos valores (limitados às faixas válidas); true se algo mudou
+bool sampling_ctl_set(uint32_t period_ms, uint32_t batch_size, uint32_t delta);
+
+uint32_t sampling_ctl_period_ms(void);
+uint32_t sampling_ctl_batch_size(void);
+
+// Report-on-change; chamado só pela tarefa de sensores
+bool sampling_ctl_should_report(const SensorData *sample);
+
+void sampling_ctl_get(sampling_ctl_t *out);
+
+#endif // SAMPLING_CTL_H
@@ -4,22 +4,49 @@ Servidor HTTP para receber dados dos sensores TCS34725 e VL53L0X
 Projeto BitDogLab com Pico W
 """
 
-from flask import Flask, request
+from array import array
+from collections import OrderedDict, deque
+from concurrent.futures import Future, ThreadPoolExecutor
 from datetime import datetime
+from urllib.parse import parse_qsl, urlsplit
+import argparse
+import asyncio
 import csv
+import json
+import math
 import os
+import random
+import shutil
+import socket
+import struct
+import sys
+import tempfile
+import threading
+import time
 
-app = Flask(__name__)
+# Flask é opcional: sem ele, só o modo assíncrono (--async)
+try:
+    from flask import Flask, Response, request
+except ImportError:
+    Flask = None
 
-# Arquivo CSV para salvar dados
+# Arquivo CSV (formato original: --storage csv e --export-csv)
 CSV_FILE = 'sensor_data.csv'
+CSV_HEADER = ['Timestamp', 'Cor', 'R', 'G', 'B', 'Clear', 'Distancia_mm', 'LED_Estado']
 
-def init_csv():
+def init_csv(path=None):
     """Inicializa o arquivo CSV com cabeçalhos se não existir"""
-    if not os.path.exists(CSV_FILE):
-        with open(CSV_FILE, 'w', newline='') as f:
+    path = path or CSV_FILE
+    if not os.path.exists(path):
+        with open(path, 'w', newline='') as f:
             writer = csv.writer(f)
-            writer.writerow(['Timestamp', 'Cor', 'R', 'G', 'B', 'Clear', 'Distancia_mm', 'LED_Estado'])
+            writer.writerow(CSV_HEADER)
+
+def csv_row(sample):
+    """Amostra armazenada -> linha do CSV (horário local)"""
+    ts, color_id, r, g, b, c, dist = sample
+    return [datetime.fromtimestamp(ts / 1000).strftime('%Y-%m-%d %H:%M:%S'),
+            COLOR_NAMES[color_id], r, g, b, c, dist, led_state(dist)]
 
 def save_to_csv(data):
     """Salva dados no arquivo CSV"""
@@ -27,56 +54,1627 @@ def save_to_csv(data):
         writer = csv.writer(f)
         writer.writerow(data)
 
-@app.route('/data')
-def receive_data():
+# ==================== Codificação binária (POST /batch) ====================
+# Mesmo formato de sample_codec.h no firmware (v2; v1 ainda é aceito)
+CODEC_VERSION = 2
+CODEC_VERSION_V1 = 1
+DEVICE_ID_LEN = 8
+COLOR_NAMES = [
+    'INDEFINIDO', 'PRETO', 'BRANCO', 'VERMELHO', 'VERDE', 'AZUL',
+    'AMARELO', 'CIANO', 'MAGENTA', 'LARANJA', 'CINZA', 'MARROM',
+]
+CHANNELS = ('r', 'g', 'b', 'c', 'dist')
+# Timestamps abaixo disso são ms desde o boot (dispositivo ainda sem SNTP);
+# mesmo valor de DEVICE_CLOCK_EPOCH_MIN_MS em device_clock.h
+EPOCH_MIN_MS = 1_000_000_000_000
+
+def _put_varint(out, value):
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+def _get_varint(data, pos):
+    value = 0
+    for shift in range(0, 64, 7):
+        if pos >= len(data):
+            break
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+    raise ValueError(f"varint inválido na posição {pos}")
+
+def encode_batch(samples, device_id, stream_id=0, seq=0, base_seq=None):
+    """Codifica amostras (dicts com ts, r, g, b, c, dist, color_id) em um lote binário v2"""
+    out = bytearray([CODEC_VERSION])
+    out += device_id
+    out += struct.pack('<I', stream_id)
+    _put_varint(out, seq)
+    _put_varint(out, seq if base_seq is None else base_seq)
+    _put_varint(out, len(samples))
+    prev_ts = samples[0]['ts'] if samples else 0
+    _put_varint(out, prev_ts)
+    prev = dict.fromkeys(CHANNELS, 0)
+    for s in samples:
+        dt = max(s['ts'] - prev_ts, 0)
+        _put_varint(out, dt)
+        prev_ts += dt
+        for ch in CHANNELS:
+            delta = s[ch] - prev[ch]
+            _put_varint(out, (delta << 1) ^ (delta >> 31))
+            prev[ch] = s[ch]
+        out.append(s['color_id'])
+    return bytes(out)
+
+def decode_batch(data):
+    """Decodifica um lote binário; levanta ValueError se estiver malformado"""
+    if len(data) < 1 + DEVICE_ID_LEN or data[0] not in (CODEC_VERSION, CODEC_VERSION_V1):
+        raise ValueError("versão ou cabeçalho inválido")
+    header = {'version': data[0], 'device_id': bytes(data[1:1 + DEVICE_ID_LEN]),
+              'stream_id': None, 'seq': None, 'base_seq': None}
+    pos = 1 + DEVICE_ID_LEN
+    if header['version'] >= 2:
+        if len(data) < pos + 4:
+            raise ValueError("cabeçalho v2 truncado")
+        header['stream_id'], = struct.unpack_from('<I', data, pos)
+        pos += 4
+        header['seq'], pos = _get_varint(data, pos)
+        header['base_seq'], pos = _get_varint(data, pos)
+        if header['base_seq'] > header['seq']:
+            raise ValueError("base_seq maior que seq")
+    count, pos = _get_varint(data, pos)
+    ts, pos = _get_varint(data, pos)
+    header['count'] = count
+    header['base_ts'] = ts
+
+    samples = []
+    prev = dict.fromkeys(CHANNELS, 0)
+    for _ in range(count):
+        dt, pos = _get_varint(data, pos)
+        ts += dt
+        sample = {'ts': ts}
+        for ch in CHANNELS:
+            raw, pos = _get_varint(data, pos)
+            value = prev[ch] + ((raw >> 1) ^ -(raw & 1))
+            if not 0 <= value <= 0xFFFF:
+                raise ValueError(f"canal {ch} fora da faixa: {value}")
+            sample[ch] = prev[ch] = value
+        if pos >= len(data) or data[pos] >= len(COLOR_NAMES):
+            raise ValueError("ID de cor ausente ou inválido")
+        sample['color_id'] = data[pos]
+        pos += 1
+        samples.append(sample)
+    if pos != len(data):
+        raise ValueError(f"{len(data) - pos} bytes sobrando no lote")
+    return header, samples
+
+# ==================== Entrega confiável (ACK cumulativo) ====================
+ACK_STATE_FILE = 'ack_state.json'
+# ack_state.json é regravado no máximo a cada ACK_STATE_SAVE_S (com --fsync
+# commit, a cada ACK e com fsync). Streams parados há ACK_STREAM_IDLE_S saem
+# do arquivo, menos o mais recente de cada dispositivo: cada boot abre um
+# stream novo e os antigos deixam de receber retransmissões
+ACK_STATE_SAVE_S = 1.0
+ACK_STREAM_IDLE_S = 24 * 3600
+
+class AckState:
+    """Janela de ACK por stream (dispositivo + boot), persistida em JSON.
+
+    acked é a maior sequência contígua já gravada; received guarda as
+    sequências gravadas fora de ordem acima dela. Sequências abaixo de
+    base_seq o dispositivo não reenvia mais, então contam como resolvidas.
+
+    O arquivo pode ficar até save_interval_s atrás da memória (e, sem fsync,
+    o que o SO ainda não escreveu se perde numa queda). Depois de um reinício
+    isso só faz gravar de novo lotes gravados cujo ACK não chegou ao
+    dispositivo: os confirmados ele não reenvia, e o base_seq dele avança o
+    ACK do stream.
+    """
+
+    def __init__(self, path, save_interval_s=ACK_STATE_SAVE_S, fsync=False):
+        self.path = path
+        self.save_interval_s = save_interval_s
+        self.fsync = fsync
+        self.lock = threading.Lock()
+        self.streams = {}
+        # (stream, seq) em gravação -> Future resolvido com o ACK depois dela
+        self.in_progress = {}
+        self.dirty = False
+        self.saved = 0.0            # time.monotonic() da última gravação
+        self.timer = None           # Gravação adiada pelo intervalo
+        self.saves = 0
+        if os.path.exists(path):
+            now = time.time()
+            with open(path) as f:
+                for key, st in json.load(f).items():
+                    self.streams[key] = {'acked': st['acked'], 'received': set(st['received']),
+                                         'seen': st.get('seen', now)}
+
+    @staticmethod
+    def key(device_id, stream_id):
+        return f"{device_id.hex()}:{stream_id:08x}"
+
+    def _stream(self, key, base_seq):
+        # Primeira vez que o stream aparece (ou estado perdido): começa na base
+        st = self.streams.setdefault(key, {'acked': base_seq - 1, 'received': set(),
+                                           'seen': time.time()})
+        if base_seq - 1 > st['acked']:
+            st['acked'] = base_seq - 1
+        st['received'] = {s for s in st['received'] if s > st['acked']}
+        while st['acked'] + 1 in st['received']:
+            st['acked'] += 1
+            st['received'].discard(st['acked'])
+        return st
+
+    def reserve(self, key, seq, base_seq):
+        """Reserva a sequência para gravação; retorna (reservada, ack, primeira).
+
+        Só quem reserva grava o lote e depois chama commit() ou release().
+        Sem reserva, primeira é None se o lote já está gravado, ou o Future
+        da cópia ainda em gravação (resolve com o ACK depois do commit dela).
+        """
+        with self.lock:
+            st = self._stream(key, base_seq)
+            if seq <= st['acked'] or seq in st['received']:
+                return False, st['acked'], None
+            first = self.in_progress.get((key, seq))
+            if first is not None:
+                return False, st['acked'], first
+            self.in_progress[(key, seq)] = Future()
+            return True, st['acked'], None
+
+    def release(self, key, seq, error):
+        """Desfaz a reserva sem gravar (cota, falha de escrita)"""
+        with self.lock:
+            first = self.in_progress.pop((key, seq), None)
+        if first is not None:
+            first.set_exception(error)
+
+    def commit(self, key, seq, base_seq):
+        """Marca a sequência como gravada; retorna o novo ACK"""
+        with self.lock:
+            st = self._stream(key, base_seq)
+            if seq > st['acked']:
+                st['received'].add(seq)
+            st = self._stream(key, base_seq)
+            st['seen'] = time.time()
+            acked = st['acked']
+            first = self.in_progress.pop((key, seq), None)
+            self.dirty = True
+            try:
+                self._save_due()
+            finally:
+                # As linhas já estão gravadas: as cópias em espera recebem o
+                # ACK mesmo se o arquivo de estado falhar
+                if first is not None:
+                    first.set_result(acked)
+        return acked
+
+    def flush(self):
+        """Grava o estado pendente já (encerramento)"""
+        with self.lock:
+            if self.timer:
+                self.timer.cancel()
+                self.timer = None
+            if self.dirty:
+                self._save()
+
+    def _save_due(self):
+        # Chamado com o lock; fora do intervalo, agenda a gravação para o fim
+        # dele em vez de regravar a cada lote
+        remaining = self.saved + self.save_interval_s - time.monotonic()
+        if remaining <= 0:
+            self._save()
+        elif self.timer is None:
+            self.timer = threading.Timer(remaining, self._save_later)
+            self.timer.daemon = True
+            self.timer.start()
+
+    def _save_later(self):
+        with self.lock:
+            self.timer = None
+            if self.dirty:
+                self._save()
+
+    def _prune(self):
+        cutoff = time.time() - ACK_STREAM_IDLE_S
+        newest = {}
+        for key, st in self.streams.items():
+            device = key.split(':', 1)[0]
+            if device not in newest or st['seen'] > self.streams[newest[device]]['seen']:
+                newest[device] = key
+        keep = set(newest.values())
+        for key in [k for k, st in self.streams.items()
+                    if st['seen'] < cutoff and k not in keep]:
+            del self.streams[key]
+
+    def _save(self):
+        self._prune()
+        tmp = self.path + '.tmp'
+        with open(tmp, 'w') as f:
+            json.dump({k: {'acked': v['acked'], 'received': sorted(v['received']),
+                           'seen': round(v['seen'])}
+                       for k, v in self.streams.items()}, f)
+            if self.fsync:
+                f.flush()
+                os.fsync(f.fileno())
+        os.replace(tmp, self.path)
+        self.dirty = False
+        self.saved = time.monotonic()
+        self.saves += 1
+
+ack_state = None
+
+# ==================== Controle da frota (resposta ao dispositivo) ====================
+# Enviado em toda resposta como "chave=valor"; o firmware aplica na hora
+# (sampling_ctl.c). Faixas aceitas pelo firmware: período 200..60000 ms,
+# lote 1..UPLINK_BATCH_SIZE, delta 0..65535
+control = {'period_ms': 1500, 'batch': 8, 'delta': 0}
+
+class Throttle:
+    """Multiplica o período enviado à frota enquanto a ingestão passa do limite"""
+
+    WINDOW_S = 10
+    MAX_FACTOR = 16
+
+    def __init__(self, max_rows_per_s):
+        self.max_rows_per_s = max_rows_per_s
+        self.lock = threading.Lock()
+        self.factor = 1
+        self.window_start = time.monotonic()
+        self.rows = 0
+
+    def note(self, rows):
+        with self.lock:
+            self.rows += rows
+            elapsed = time.monotonic() - self.window_start
+            if elapsed < self.WINDOW_S:
+                return
+            rate = self.rows / elapsed
+            previous = self.factor
+            if rate > self.max_rows_per_s:
+                self.factor = min(self.factor * 2, self.MAX_FACTOR)
+            elif rate < self.max_rows_per_s / 2:
+                self.factor = max(self.factor // 2, 1)
+            if self.factor != previous:
+                print(f"🚦 Ingestão {rate:.1f} linhas/s: período x{self.factor}")
+            self.window_start += elapsed
+            self.rows = 0
+
+throttle = None
+
+def control_lines():
+    """Parâmetros efetivos para a frota (com o fator de throttle aplicado)"""
+    period = control['period_ms'] * (throttle.factor if throttle else 1)
+    return [f"period_ms={min(period, 60000)}", f"batch={control['batch']}",
+            f"delta={control['delta']}"]
+
+def note_rows(rows):
+    if throttle:
+        throttle.note(rows)
+
+# ==================== Cotas por dispositivo ====================
+# Um dispositivo com defeito (ou em rajada longa) não pode ocupar a gravação
+# dos outros: cada um tem um token bucket de linhas/s e um teto de linhas na
+# fila do writer. Acima disso a requisição leva 429; o firmware trata como
+# falha (o lote fica na janela e o AIMD reduz a taxa), sem trocar de servidor
+DEVICE_MAX_ROWS_PER_S = 100     # Firmware no limite: 5 req/s x 8 amostras = 40
+DEVICE_BURST_ROWS = 256         # Janela inteira (8 lotes x 8) e folga na volta de queda
+DEVICE_QUEUE_ROWS = 1024
+INGEST_RATE_TAU_S = 10          # Constante de tempo da taxa média exibida
+INGEST_MAX_DEVICES = 10000      # Estado mantido; sai o calado há mais tempo
+
+class DeviceQuota:
+    __slots__ = ('tokens', 'last', 'rate', 'rows', 'requests', 'rejected', 'dropped_rows')
+
+    def __init__(self, burst, now):
+        self.tokens = burst
+        self.last = now
+        self.rate = 0.0
+        self.rows = 0
+        self.requests = 0
+        self.rejected = 0
+        self.dropped_rows = 0
+
+class IngestQuotas:
+    def __init__(self, max_rows_per_s=DEVICE_MAX_ROWS_PER_S, burst_rows=DEVICE_BURST_ROWS,
+                 queue_rows=DEVICE_QUEUE_ROWS):
+        self.max_rows_per_s = max_rows_per_s
+        self.burst_rows = burst_rows
+        self.queue_rows = queue_rows
+        self.devices = OrderedDict()    # id -> DeviceQuota, do menos ao mais recente
+        self.lock = threading.Lock()
+
+    def admit(self, device, rows, queued):
+        """None se as linhas podem ir para o writer, senão o motivo da recusa"""
+        now = time.monotonic()
+        with self.lock:
+            quota = self.devices.pop(device, None)
+            if quota is None:
+                if len(self.devices) >= INGEST_MAX_DEVICES:
+                    self.devices.popitem(last=False)
+                quota = DeviceQuota(self.burst_rows, now)
+            self.devices[device] = quota
+
+            elapsed = now - quota.last
+            quota.last = now
+            quota.tokens = min(quota.tokens + elapsed * self.max_rows_per_s, self.burst_rows)
+            quota.rate *= math.exp(-elapsed / INGEST_RATE_TAU_S)
+            quota.requests += 1
+            reason = None
+            if queued + rows > self.queue_rows:
+                reason = 'queue'
+            elif rows > quota.tokens:
+                reason = 'rate'
+            if reason:
+                quota.rejected += 1
+                quota.dropped_rows += rows
+                return reason
+            quota.tokens -= rows
+            quota.rows += rows
+            quota.rate += rows / INGEST_RATE_TAU_S
+            return None
+
+    def status(self):
+        now = time.monotonic()
+        with self.lock:
+            devices = {
+                device: {'rows': q.rows,
+                         'rows_per_s': round(q.rate * math.exp(-(now - q.last) / INGEST_RATE_TAU_S), 2),
+                         'requests': q.requests, 'rejected': q.rejected,
+                         'dropped_rows': q.dropped_rows,
+                         'queued_rows': writer.pending_rows(device) if writer else 0}
+                for device, q in self.devices.items()
+            }
+        return {'max_rows_per_s': self.max_rows_per_s, 'burst_rows': self.burst_rows,
+                'queue_rows': self.queue_rows,
+                'rejected': sum(d['rejected'] for d in devices.values()),
+                'dropped_rows': sum(d['dropped_rows'] for d in devices.values()),
+                'devices': devices}
+
+quotas = IngestQuotas()
+
+def quota_response(device, reason):
+    if VERBOSE:
+        print(f"⛔ Dispositivo {device or '(sem ID)'} acima da cota ({reason})")
+    return text_response(f"BUSY {reason}\n", 429)
+
+# ==================== Injeção de falhas (teste de failover) ====================
+# Vários server.py na mesma máquina (--port/--data-dir) fazem o papel dos
+# servidores de ingestão do firmware; /fault deixa um deles lento ou com erro
+fault = {'delay_ms': 0, 'fail': 0}
+
+FAULT_PATHS = ('/data', '/batch')
+
+def led_state(dist):
+    """Estado do LED conforme a distância (mesma regra do firmware)"""
+    try:
+        return "VERMELHO" if int(dist) < 150 else "VERDE"
+    except (TypeError, ValueError):
+        return "DESLIGADO"
+
+# Sem captura (ou com ela vazia), o relatório usa amostras sintéticas
+CODEC_SYNTHETIC_SAMPLES = 2000
+CODEC_FUZZ_ITERATIONS = 20000
+
+def synthetic_samples(count, seed=1):
+    """Leituras parecidas com as do sensor: canais estáveis com ruído, trocas
+    de objeto de vez em quando, período ~1,5 s e relógio sincronizado"""
+    rng = random.Random(seed)
+    ts = 1_760_000_000_000
+    base = {'r': 800, 'g': 900, 'b': 700, 'c': 2600, 'dist': 120}
+    color_id = 2
+    samples = []
+    for _ in range(count):
+        if rng.random() < 0.05:
+            base = {ch: rng.randrange(0x10000) if ch != 'dist' else rng.randrange(20, 2000)
+                    for ch in CHANNELS}
+            color_id = rng.randrange(len(COLOR_NAMES))
+        ts += 1500 + rng.randrange(-20, 21)
+        sample = {'ts': ts, 'color_id': color_id}
+        for ch in CHANNELS:
+            sample[ch] = min(max(base[ch] + rng.randrange(-8, 9), 0), 0xFFFF)
+        samples.append(sample)
+    return samples
+
+def load_capture(csv_path):
+    rows = []
+    with open(csv_path, newline='') as f:
+        for row in csv.DictReader(f):
+            ts = datetime.strptime(row['Timestamp'], '%Y-%m-%d %H:%M:%S')
+            rows.append({
+                'ts': int(ts.timestamp() * 1000),
+                'r': int(row['R']), 'g': int(row['G']), 'b': int(row['B']),
+                'c': int(row['Clear']), 'dist': int(row['Distancia_mm']),
+                'color_id': COLOR_NAMES.index(row['Cor']) if row['Cor'] in COLOR_NAMES else 0,
+            })
+    return rows
+
+def mutate_batch(data, rng):
+    """Corrompe um lote: truncado, bytes trocados, bits invertidos, inserção/remoção"""
+    data = bytearray(data)
+    kind = rng.randrange(5)
+    if kind == 0:
+        return bytes(data[:rng.randrange(len(data))])
+    for _ in range(rng.randint(1, 4)):
+        pos = rng.randrange(len(data))
+        if kind == 1:
+            data[pos] = rng.randrange(256)
+        elif kind == 2:
+            data[pos] ^= 1 << rng.randrange(8)
+        elif kind == 3:
+            data.insert(pos, rng.randrange(256))
+        elif len(data) > 1:
+            del data[pos]
+    return bytes(data)
+
+def codec_fuzz(batches, iterations, seed=1):
+    """decode_batch em lotes corrompidos: só pode aceitar ou levantar ValueError"""
+    rng = random.Random(seed)
+    rejected = 0
+    for _ in range(iterations):
+        data = mutate_batch(rng.choice(batches), rng)
+        try:
+            header, samples = decode_batch(data)
+        except ValueError:
+            rejected += 1
+            continue
+        # Aceito: precisa ser um lote coerente
+        assert header['count'] == len(samples)
+        assert all(0 <= s[ch] <= 0xFFFF for s in samples for ch in CHANNELS)
+        assert all(s['color_id'] < len(COLOR_NAMES) for s in samples)
+    return rejected
+
+def codec_report(csv_path, batch_size, fuzz_iterations=CODEC_FUZZ_ITERATIONS):
+    """Compara bytes ASCII (GET /data) vs lotes binários e valida o decodificador:
+    round-trip de cada lote, todos os prefixos truncados e mutações aleatórias"""
+    rows = load_capture(csv_path) if csv_path else []
+    source = csv_path
+    if not rows:
+        rows = synthetic_samples(CODEC_SYNTHETIC_SAMPLES)
+        source = "sintéticas" + (f", {csv_path} vazio" if csv_path else "")
+
+    ascii_bytes = sum(len(f"/data?r={s['r']}&g={s['g']}&b={s['b']}&c={s['c']}&dist={s['dist']}")
+                      for s in rows)
+    binary_bytes = 0
+    batches = []
+    device_id = bytes(range(1, DEVICE_ID_LEN + 1))
+    for i in range(0, len(rows), batch_size):
+        batch = rows[i:i + batch_size]
+        seq = i // batch_size
+        encoded = encode_batch(batch, device_id, stream_id=0x1234ABCD, seq=seq, base_seq=seq)
+        header, decoded = decode_batch(encoded)
+        assert decoded == batch, f"round-trip divergente no lote {seq}"
+        assert header['seq'] == seq and header['device_id'] == device_id
+        for cut in range(len(encoded)):
+            try:
+                decode_batch(encoded[:cut])
+            except ValueError:
+                continue
+            raise AssertionError(f"lote {seq} truncado em {cut} bytes foi aceito")
+        binary_bytes += len(encoded)
+        batches.append(encoded)
+    rejected = codec_fuzz(batches, fuzz_iterations)
+
+    print(f"Amostras: {len(rows)} ({source}; lotes de {batch_size})")
+    print(f"Round-trip: {len(batches)} lotes OK, todos os prefixos truncados recusados")
+    print(f"Fuzz: {fuzz_iterations} lotes corrompidos, {rejected} recusados, "
+          f"{fuzz_iterations - rejected} aceitos e coerentes")
+    print(f"ASCII (URI):  {ascii_bytes} bytes ({ascii_bytes / len(rows):.1f} B/amostra)")
+    print(f"Binário:      {binary_bytes} bytes ({binary_bytes / len(rows):.1f} B/amostra)")
+    print(f"Compressão:   {ascii_bytes / binary_bytes:.2f}x")
+
+# ==================== Stand-in NTP (testes sem servidor NTP) ====================
+NTP_EPOCH_OFFSET = 2208988800   # 1900-01-01 -> 1970-01-01
+
+def _ntp_timestamp(t):
+    sec = int(t)
+    return ((sec + NTP_EPOCH_OFFSET) & 0xFFFFFFFF) << 32 | int((t - sec) * 2**32)
+
+def ntp_reply(request_data, received, transmit):
+    """Resposta SNTPv4 (modo servidor, estrato 1) para uma requisição cliente"""
+    if len(request_data) < 48 or request_data[0] & 0x07 != 3:
+        return None
+    version = (request_data[0] >> 3) & 0x07
+    originate, = struct.unpack('!Q', request_data[40:48])
+    return struct.pack('!BBbbII4sQQQQ',
+                       (version << 3) | 4,      # LI=0, modo 4 (servidor)
+                       1,                       # estrato 1: relógio de referência
+                       request_data[2],         # poll
+                       -20,                     # precisão ~1 µs
+                       0, 0, b'LOCL',
+                       _ntp_timestamp(received),
+                       originate,               # conferido pelo lwIP (SNTP_CHECK_RESPONSE 2)
+                       _ntp_timestamp(received),
+                       _ntp_timestamp(transmit()))
+
+def ntp_standin(port):
+    """Responde SNTP com o relógio desta máquina (thread de fundo)"""
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(('0.0.0.0', port))
+    while True:
+        data, addr = sock.recvfrom(512)
+        reply = ntp_reply(data, time.time(), time.time)
+        if reply:
+            sock.sendto(reply, addr)
+
+# ==================== Armazenamento colunar por hora ====================
+# Cada dispositivo tem um diretório em segments/ (segments/<id>/; amostras
+# sem ID ficam direto em segments/) e cada hora (UTC) é um diretório dentro
+# dele com um arquivo binário por coluna (array tipado, little-endian) e um
+# index.json com faixa de tempo, número de linhas e min/max/soma por coluna,
+# além de agregados por minuto. Consultas por intervalo leem só os segmentos (e
+# colunas) que interessam; o CSV virou exportação.
+SEGMENTS_DIR = 'segments'
+SEGMENT_MS = 3600 * 1000
+# Amostra armazenada: (ts_ms UTC, color_id, r, g, b, c, dist)
+SEGMENT_COLUMNS = (('ts', 'q'), ('color_id', 'B'), ('r', 'H'), ('g', 'H'),
+                   ('b', 'H'), ('c', 'H'), ('dist', 'H'))
+# Segmentos com arquivos abertos (7 descritores cada): a hora atual de cada
+# dispositivo ativo e retransmissões antigas; acima disso fecha o menos usado
+SEGMENT_MAX_OPEN = 64
+# Atraso máximo do index.json (e portanto do que /query e --export-csv
+# enxergam) em relação às colunas
+SEGMENT_INDEX_SAVE_S = 1.0
+# Agregados por minuto no índice: minuto -> [linhas, min, max, soma de cada
+# canal de ROLLUP_FIELDS]
+ROLLUP_MS = 60 * 1000
+ROLLUP_FIELDS = ('r', 'g', 'b', 'c', 'dist')
+
+def segment_name(start_ms):
+    return time.strftime('%Y%m%dT%H', time.gmtime(start_ms / 1000))
+
+def parse_device(value):
+    """ID do dispositivo (hex do ID da placa, até 8 bytes) em minúsculas; '' = sem ID"""
+    value = (value or '').strip().lower()
+    if len(value) > 2 * DEVICE_ID_LEN or any(ch not in '0123456789abcdef' for ch in value):
+        raise ValueError(f"ID de dispositivo inválido: {value!r}")
+    return value
+
+def device_directory(directory, device):
+    return os.path.join(directory, device) if device else directory
+
+def list_devices(directory):
+    """Dispositivos com segmentos gravados ('' = amostras sem ID, na raiz)"""
+    if not os.path.isdir(directory):
+        return []
+    devices = []
+    for name in sorted(os.listdir(directory)):
+        path = os.path.join(directory, name)
+        if not os.path.isdir(path):
+            continue
+        if os.path.exists(os.path.join(path, 'index.json')):
+            if '' not in devices:
+                devices.insert(0, '')
+        else:
+            devices.append(name)
+    return devices
+
+def make_sample(ts_ms, color_id, r, g, b, c, dist):
+    """Amostra no formato armazenado, com os canais limitados a uint16"""
+    clamp = lambda v: min(max(int(v), 0), 0xFFFF)
+    color_id = int(color_id)
+    return (int(ts_ms), color_id if 0 <= color_id < len(COLOR_NAMES) else 0,
+            clamp(r), clamp(g), clamp(b), clamp(c), clamp(dist))
+
+class Segment:
+    """Uma hora de amostras, aberta para acréscimo.
+
+    As colunas são a verdade; o index.json é um resumo regravado depois delas
+    (a cada SEGMENT_INDEX_SAVE_S e no sync/close). Ao reabrir, se as colunas
+    não baterem com o índice (queda entre os dois), o índice é refeito a
+    partir das linhas completas em todas as colunas.
+    """
+
+    def __init__(self, directory, start_ms):
+        self.path = os.path.join(directory, segment_name(start_ms))
+        os.makedirs(self.path, exist_ok=True)
+        self.index = read_segment_index(self.path)
+        paths = [os.path.join(self.path, f'{name}.col') for name, _ in SEGMENT_COLUMNS]
+        rows = min(os.path.getsize(path) // array(code).itemsize if os.path.exists(path) else 0
+                   for path, (_, code) in zip(paths, SEGMENT_COLUMNS))
+        rebuild = (self.index is None or self.index['rows'] != rows or
+                   'minutes' not in self.index)
+        if rebuild:
+            self.index = new_segment_index(start_ms)
+            if rows:
+                data = read_segment(dict(self.index, rows=rows, path=self.path))
+                self._account(list(zip(*(data[name] for name, _ in SEGMENT_COLUMNS))))
+        # Linha incompleta (queda no meio de uma escrita) é descartada
+        self.files = []
+        for path, (_, code) in zip(paths, SEGMENT_COLUMNS):
+            f = open(path, 'ab')
+            f.truncate(rows * array(code).itemsize)
+            self.files.append(f)
+        self.dirty = False
+        self.unsynced = False
+        self.index_dirty = rebuild
+
+    def append(self, samples):
+        columns = list(zip(*samples))
+        for (_, code), f, values in zip(SEGMENT_COLUMNS, self.files, columns):
+            data = array(code, values)
+            if sys.byteorder != 'little':
+                data.byteswap()
+            data.tofile(f)
+        self._account(samples, columns)
+        self.dirty = True
+        self.unsynced = True
+
+    def _account(self, samples, columns=None):
+        """Soma as amostras nas estatísticas do índice"""
+        columns = columns or list(zip(*samples))
+        idx = self.index
+        for (name, _), values in zip(SEGMENT_COLUMNS, columns):
+            lo, hi = min(values), max(values)
+            if name == 'ts':
+                idx['min_ts'] = lo if idx['min_ts'] is None else min(idx['min_ts'], lo)
+                idx['max_ts'] = hi if idx['max_ts'] is None else max(idx['max_ts'], hi)
+                continue
+            st = idx['columns'][name]
+            st['min'] = lo if st['min'] is None else min(st['min'], lo)
+            st['max'] = hi if st['max'] is None else max(st['max'], hi)
+            st['sum'] += sum(values)
+        idx['rows'] += len(samples)
+        self._roll(samples, columns)
+
+    def _roll(self, samples, columns=None):
+        """Soma as amostras nos agregados por minuto (um lote cai quase sempre em um só)"""
+        start = self.index['start_ms']
+        columns = columns or list(zip(*samples))
+        first = (min(columns[0]) - start) // ROLLUP_MS
+        if first == (max(columns[0]) - start) // ROLLUP_MS:
+            groups = {first: columns}
+        else:
+            by_minute = {}
+            for s in samples:
+                by_minute.setdefault((s[0] - start) // ROLLUP_MS, []).append(s)
+            groups = {m: list(zip(*rows)) for m, rows in by_minute.items()}
+
+        minutes = self.index['minutes']
+        for minute, cols in groups.items():
+            entry = minutes.get(str(minute))
+            if entry is None:
+                entry = minutes[str(minute)] = [0] + [None, None, 0] * len(ROLLUP_FIELDS)
+            entry[0] += len(cols[0])
+            for k, values in enumerate(cols[2:]):
+                lo, hi = min(values), max(values)
+                i = 1 + 3 * k
+                entry[i] = lo if entry[i] is None else min(entry[i], lo)
+                entry[i + 1] = hi if entry[i + 1] is None else max(entry[i + 1], hi)
+                entry[i + 2] += sum(values)
+
+    def flush(self):
+        if self.dirty:
+            for f in self.files:
+                f.flush()
+            self.dirty = False
+            self.index_dirty = True
+
+    def save_index(self):
+        """Colunas primeiro, índice depois: o índice nunca conta linhas não gravadas"""
+        self.flush()
+        if not self.index_dirty:
+            return
+        tmp = os.path.join(self.path, 'index.json.tmp')
+        with open(tmp, 'w') as f:
+            json.dump(self.index, f)
+        os.replace(tmp, os.path.join(self.path, 'index.json'))
+        self.index_dirty = False
+
+    def sync(self):
+        """fsync só se houve escrita desde o último: com um segmento por
+        dispositivo, a maioria dos abertos está parada"""
+        if not self.unsynced:
+            return
+        self.flush()
+        for f in self.files:
+            os.fsync(f.fileno())
+        self.unsynced = False
+
+    def close(self):
+        self.save_index()
+        for f in self.files:
+            f.close()
+
+def new_segment_index(start_ms):
+    return {
+        'start_ms': start_ms, 'end_ms': start_ms + SEGMENT_MS, 'rows': 0,
+        'min_ts': None, 'max_ts': None,
+        'columns': {name: {'min': None, 'max': None, 'sum': 0}
+                    for name, _ in SEGMENT_COLUMNS[1:]},
+        'minutes': {},
+    }
+
+def read_segment_index(path):
+    try:
+        with open(os.path.join(path, 'index.json')) as f:
+            return json.load(f)
+    except FileNotFoundError:
+        return None
+
+class SegmentStore:
+    """Sink do RowWriter: distribui as amostras por dispositivo e hora"""
+
+    name = 'segments'
+
+    def __init__(self, directory):
+        self.directory = self.location = directory
+        os.makedirs(directory, exist_ok=True)
+        # (dispositivo, start_ms) -> Segment, do menos ao mais recente em uso
+        self.open = OrderedDict()
+        self.index_saved = time.monotonic()
+
+    def _segment(self, device, start_ms):
+        key = (device, start_ms)
+        segment = self.open.pop(key, None)
+        if segment is None:
+            if len(self.open) >= SEGMENT_MAX_OPEN:
+                _, oldest = self.open.popitem(last=False)
+                oldest.close()
+            segment = Segment(device_directory(self.directory, device), start_ms)
+        self.open[key] = segment
+        return segment
+
+    def write(self, device, samples):
+        by_hour = {}
+        for s in samples:
+            by_hour.setdefault(s[0] - s[0] % SEGMENT_MS, []).append(s)
+        for start_ms, hour in by_hour.items():
+            self._segment(device, start_ms).append(hour)
+
+    def flush(self):
+        for segment in self.open.values():
+            segment.flush()
+        # Índices saem em lote: um por segmento a cada SEGMENT_INDEX_SAVE_S,
+        # e não um por segmento em cada grupo
+        if time.monotonic() - self.index_saved >= SEGMENT_INDEX_SAVE_S:
+            self.save_indexes()
+
+    def save_indexes(self):
+        for segment in self.open.values():
+            segment.save_index()
+        self.index_saved = time.monotonic()
+
+    def sync(self):
+        for segment in self.open.values():
+            segment.sync()
+        self.save_indexes()
+
+    def close(self):
+        for segment in self.open.values():
+            segment.close()
+        self.open.clear()
+
+def list_segments(directory, from_ms=None, to_ms=None):
+    """Índices dos segmentos com amostras em [from_ms, to_ms), em ordem de tempo"""
+    if not os.path.isdir(directory):
+        return []
+    found = []
+    for name in sorted(os.listdir(directory)):
+        index = read_segment_index(os.path.join(directory, name))
+        if not index or not index['rows']:
+            continue
+        if from_ms is not None and index['max_ts'] < from_ms:
+            continue
+        if to_ms is not None and index['min_ts'] >= to_ms:
+            continue
+        found.append(dict(index, path=os.path.join(directory, name)))
+    return found
+
+def read_segment(index, columns=None):
+    """Colunas de um segmento como arrays (só as linhas contadas no índice)"""
+    names = columns or [name for name, _ in SEGMENT_COLUMNS]
+    codes = dict(SEGMENT_COLUMNS)
+    data = {}
+    for name in names:
+        values = array(codes[name])
+        with open(os.path.join(index['path'], f'{name}.col'), 'rb') as f:
+            values.fromfile(f, index['rows'])
+        if sys.byteorder != 'little':
+            values.byteswap()
+        data[name] = values
+    return data
+
+def read_samples(directory, from_ms=None, to_ms=None):
+    """Amostras em [from_ms, to_ms), ordenadas por timestamp em cada segmento"""
+    for index in list_segments(directory, from_ms, to_ms):
+        data = read_segment(index)
+        rows = zip(*(data[name] for name, _ in SEGMENT_COLUMNS))
+        for sample in sorted(rows):
+            if (from_ms is None or sample[0] >= from_ms) and (to_ms is None or sample[0] < to_ms):
+                yield sample
+
+# ==================== Consultas por intervalo (/query) ====================
+# Agregados por balde de tempo (alinhado a 1970, UTC). Cada segmento responde
+# pelo que já tem pronto: a hora inteira pelo index.json quando o balde é
+# múltiplo de 1 h, os minutos inteiros pelos agregados por minuto quando é
+# múltiplo de 1 min; só minutos cortados por from/to ou baldes menores leem
+# as colunas brutas
+QUERY_DEFAULT_MS = 24 * 3600 * 1000
+QUERY_MAX_BUCKETS = 10000
+# Balde automático: o menor que deixa o intervalo em até QUERY_AUTO_BUCKETS
+QUERY_AUTO_BUCKETS = 500
+QUERY_BUCKETS_MS = [m * ROLLUP_MS for m in (1, 5, 15, 60, 360, 1440)]
+QUERY_WORKERS = 2
+
+def parse_duration_ms(value):
+    """'90' (segundos), '500ms', '30s', '5m', '1h' ou '1d' em ms"""
+    units = {'ms': 1, 's': 1000, 'm': 60000, 'h': 3600000, 'd': 86400000}
+    value = value.strip().lower()
+    for unit in ('ms', 's', 'm', 'h', 'd'):
+        if value.endswith(unit) and value[:-len(unit)].isdigit():
+            return int(value[:-len(unit)]) * units[unit]
+    return int(value) * 1000
+
+def query_range(directory, from_ms, to_ms, bucket_ms, fields=ROLLUP_FIELDS):
+    """Linhas e min/max/média de cada campo por balde em [from_ms, to_ms)"""
+    buckets = {}
+    scanned = {'segments': 0, 'hours': 0, 'minutes': 0, 'raw_rows': 0}
+    field_index = [ROLLUP_FIELDS.index(f) for f in fields]
+
+    def add(t, count, stats):
+        start = t - t % bucket_ms
+        acc = buckets.get(start)
+        if acc is None:
+            buckets[start] = [count] + [list(st) for st in stats]
+            return
+        acc[0] += count
+        for st, (lo, hi, total) in zip(acc[1:], stats):
+            st[0] = min(st[0], lo)
+            st[1] = max(st[1], hi)
+            st[2] += total
+
+    for index in list_segments(directory, from_ms, to_ms):
+        scanned['segments'] += 1
+        start, end = index['start_ms'], index['end_ms']
+        if from_ms <= start and end <= to_ms and bucket_ms % SEGMENT_MS == 0:
+            columns = index['columns']
+            add(start, index['rows'], [(columns[f]['min'], columns[f]['max'], columns[f]['sum'])
+                                       for f in fields])
+            scanned['hours'] += 1
+            continue
+
+        # Minutos inteiros pelos agregados; os cortados ficam para as colunas
+        partial = None
+        if bucket_ms % ROLLUP_MS == 0 and 'minutes' in index:
+            partial = set()
+            for key, entry in index['minutes'].items():
+                t = start + int(key) * ROLLUP_MS
+                if from_ms <= t and t + ROLLUP_MS <= to_ms:
+                    add(t, entry[0], [entry[1 + 3 * k:4 + 3 * k] for k in field_index])
+                    scanned['minutes'] += 1
+                elif t < to_ms and t + ROLLUP_MS > from_ms:
+                    partial.add(t)
+            if not partial:
+                continue
+
+        data = read_segment(index, ['ts'] + list(fields))
+        values = [data[f] for f in fields]
+        for i, t in enumerate(data['ts']):
+            if t < from_ms or t >= to_ms:
+                continue
+            if partial is not None and t - t % ROLLUP_MS not in partial:
+                continue
+            add(t, 1, [(v[i], v[i], v[i]) for v in values])
+            scanned['raw_rows'] += 1
+
+    result = []
+    for start in sorted(buckets):
+        acc = buckets[start]
+        item = {'t': start, 'count': acc[0]}
+        for f, (lo, hi, total) in zip(fields, acc[1:]):
+            item[f] = {'min': lo, 'max': hi, 'mean': round(total / acc[0], 2)}
+        result.append(item)
+    return result, scanned
+
+class CsvSink:
+    """Sink do RowWriter no formato antigo: sensor_data.csv para amostras sem
+    ID e sensor_data_<id>.csv por dispositivo"""
+
+    name = 'csv'
+
+    def __init__(self, path):
+        self.path = self.location = path
+        os.makedirs(os.path.dirname(path) or '.', exist_ok=True)
+        self.files = OrderedDict()  # dispositivo -> arquivo, do menos ao mais recente
+
+    def device_path(self, device):
+        if not device:
+            return self.path
+        base, ext = os.path.splitext(self.path)
+        return f"{base}_{device}{ext}"
+
+    def write(self, device, samples):
+        f = self.files.pop(device, None)
+        if f is None:
+            if len(self.files) >= SEGMENT_MAX_OPEN:
+                _, oldest = self.files.popitem(last=False)
+                oldest.close()
+            path = self.device_path(device)
+            init_csv(path)
+            f = open(path, 'a', newline='')
+        self.files[device] = f
+        csv.writer(f).writerows(csv_row(s) for s in samples)
+
+    def flush(self):
+        for f in self.files.values():
+            f.flush()
+
+    def sync(self):
+        for f in self.files.values():
+            os.fsync(f.fileno())
+
+    def close(self):
+        for f in self.files.values():
+            f.close()
+        self.files.clear()
+
+def export_csv(directory, out_path, from_ms=None, to_ms=None):
+    """Exporta os segmentos para o formato CSV antigo; retorna o número de linhas"""
+    rows = 0
+    with open(out_path, 'w', newline='') as f:
+        out = csv.writer(f)
+        out.writerow(CSV_HEADER)
+        for sample in read_samples(directory, from_ms, to_ms):
+            out.writerow(csv_row(sample))
+            rows += 1
+    return rows
+
+def open_storage(kind, data_dir):
+    """Sink do RowWriter: 'segments' (padrão) ou 'csv' (formato antigo)"""
+    if kind == 'csv':
+        return CsvSink(os.path.join(data_dir, CSV_FILE))
+    return SegmentStore(os.path.join(data_dir, SEGMENTS_DIR))
+
+def parse_time_arg(value):
+    """ms desde 1970 ou data ISO (horário local): '2026-10-19 05:00'"""
+    if value is None:
+        return None
+    try:
+        return int(value)
+    except ValueError:
+        return int(datetime.fromisoformat(value).timestamp() * 1000)
+
+# ==================== Gravação em segundo plano ====================
+FSYNC_POLICIES = ('never', 'interval', 'commit')
+
+class RowWriter:
+    """Grava as amostras no sink (segmentos ou CSV) em uma thread de fundo.
+
+    Group commit: as linhas acumulam em memória até flush_rows linhas ou
+    flush_ms desde a primeira pendente, e saem em uma única escrita + flush.
+    fsync: 'commit' a cada grupo (ACK só depois de estar no disco),
+    'interval' no máximo a cada fsync_interval_s, 'never' deixa com o SO.
+    O Future de submit() resolve depois do grupo gravado (com o retorno de
+    on_written, chamado na thread do writer), para o ACK só sair depois.
+
+    Cada dispositivo tem a sua fila; o grupo é montado em rodízio, um lote de
+    cada dispositivo com pendência por vez, então um dispositivo com milhares
+    de linhas na fila ocupa só a sua parte de cada grupo.
+    """
+
+    def __init__(self, sink, flush_rows=256, flush_ms=50, fsync='interval', fsync_interval_s=1.0):
+        if fsync not in FSYNC_POLICIES:
+            raise ValueError(f"política de fsync inválida: {fsync}")
+        self.sink = sink
+        self.flush_rows = flush_rows
+        self.flush_s = flush_ms / 1000
+        self.fsync = fsync
+        self.fsync_interval_s = fsync_interval_s
+        self.cond = threading.Condition()
+        self.queues = {}            # dispositivo -> deque de (linhas, on_written, future)
+        self.queued_rows = {}       # dispositivo -> linhas na fila
+        self.ready = deque()        # Dispositivos com fila, na ordem do rodízio
+        self.total_rows = 0
+        self.oldest = None          # Chegada do item pendente mais antigo
+        self.closing = False
+        self.rows_written = 0
+        self.groups = 0
+        self.fsyncs = 0
+        self.max_group = 0
+        self.thread = threading.Thread(target=self._run, name='row-writer', daemon=True)
+        self.thread.start()
+
+    def submit(self, rows, on_written=None, device=''):
+        future = Future()
+        with self.cond:
+            q = self.queues.get(device)
+            if q is None:
+                q = self.queues[device] = deque()
+                self.queued_rows[device] = 0
+                self.ready.append(device)
+            q.append((rows, on_written, future))
+            self.queued_rows[device] += len(rows)
+            self.total_rows += len(rows)
+            if self.oldest is None:
+                self.oldest = time.monotonic()
+            self.cond.notify()
+        return future
+
+    def pending(self):
+        return self.total_rows
+
+    def pending_rows(self, device):
+        return self.queued_rows.get(device, 0)
+
+    def close(self):
+        """Grava o que estiver pendente, faz fsync e fecha o sink"""
+        if self.thread.is_alive():
+            with self.cond:
+                self.closing = True
+                self.cond.notify()
+            self.thread.join()
+
+    def _take(self):
+        """Até flush_rows linhas em rodízio entre os dispositivos (chamado com o lock)"""
+        group, rows = [], 0
+        while self.ready and rows < self.flush_rows:
+            device = self.ready.popleft()
+            q = self.queues[device]
+            item = q.popleft()
+            group.append((device,) + item)
+            rows += len(item[0])
+            self.queued_rows[device] -= len(item[0])
+            if q:
+                self.ready.append(device)
+            else:
+                del self.queues[device], self.queued_rows[device]
+        self.total_rows -= rows
+        self.oldest = time.monotonic() if self.total_rows else None
+        return group, rows
+
+    def _commit(self, group, rows, last_sync):
+        try:
+            # Uma escrita por dispositivo no grupo, não uma por requisição
+            by_device = {}
+            for device, item_rows, _, _ in group:
+                by_device.setdefault(device, []).extend(item_rows)
+            for device, device_rows in by_device.items():
+                self.sink.write(device, device_rows)
+            self.sink.flush()
+            now = time.monotonic()
+            if self.fsync == 'commit' or (self.fsync == 'interval' and
+                                          now - last_sync >= self.fsync_interval_s):
+                self.sink.sync()
+                self.fsyncs += 1
+                last_sync = now
+        except OSError as e:
+            # Disco cheio etc.: sem ACK para o grupo, o dispositivo retransmite
+            print(f"❌ Falha ao gravar {rows} linhas: {e}")
+            for _, _, _, future in group:
+                future.set_exception(e)
+            return last_sync
+        self.rows_written += rows
+        self.groups += 1
+        self.max_group = max(self.max_group, rows)
+        for _, _, on_written, future in group:
+            try:
+                future.set_result(on_written() if on_written else None)
+            except Exception as e:
+                future.set_exception(e)
+        return last_sync
+
+    def _run(self):
+        last_sync = time.monotonic()
+        while True:
+            idle = False
+            with self.cond:
+                # Espera um grupo cheio ou o prazo do item mais antigo
+                while not self.closing:
+                    if self.total_rows >= self.flush_rows:
+                        break
+                    if self.oldest is None:
+                        # Ocioso: o sink ainda conclui o que adiou (índices)
+                        if not self.cond.wait(SEGMENT_INDEX_SAVE_S) and self.oldest is None:
+                            idle = True
+                            break
+                        continue
+                    remaining = self.oldest + self.flush_s - time.monotonic()
+                    if remaining <= 0:
+                        break
+                    self.cond.wait(remaining)
+                if self.closing and not self.total_rows:
+                    break
+                if not idle:
+                    group, rows = self._take()
+            if idle:
+                self.sink.flush()
+                continue
+            last_sync = self._commit(group, rows, last_sync)
+        if self.fsync != 'never':
+            self.sink.sync()
+            self.fsyncs += 1
+        self.sink.close()
+
+    def stats(self):
+        return {'rows_written': self.rows_written, 'groups': self.groups,
+                'fsyncs': self.fsyncs, 'max_group': self.max_group,
+                'queue': self.pending(), 'queued_devices': len(self.queues),
+                'fsync': self.fsync, 'storage': self.sink.name}
+
+writer = None
+
+BENCH_THREADS = 4       # Threads de requisição (como o Flask com threaded)
+BENCH_INFLIGHT = 3      # Requisições em curso por dispositivo (UPLINK_MAX_INFLIGHT)
+
+def writer_bench(devices, seconds, batch):
+    """Linhas/s sob N dispositivos simulados: save_to_csv por linha (abre e
+    fecha o arquivo) vs RowWriter, contando só linhas já gravadas (o que o
+    ACK de /batch espera)"""
+    global CSV_FILE
+    workdir = tempfile.mkdtemp(prefix='writer_bench_')
+    rows = [make_sample(time.time() * 1000, 4, 120, 340, 210, 900, 150)] * batch
+
+    def run(label, worker):
+        stop = time.monotonic() + seconds
+        counts = [0] * BENCH_THREADS
+        threads = [threading.Thread(target=worker, args=(i, stop, counts))
+                   for i in range(BENCH_THREADS)]
+        start = time.monotonic()
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        rate = sum(counts) / (time.monotonic() - start)
+        print(f"{label:<36} {rate:>10.0f} linhas/s")
+        return rate
+
+    def legacy_worker(i, stop, counts):
+        while time.monotonic() < stop:
+            for sample in rows:
+                save_to_csv(csv_row(sample))
+            counts[i] += batch
+
+    def writer_worker(i, stop, counts):
+        # Cada thread atende uma fatia dos dispositivos; cada dispositivo
+        # mantém até BENCH_INFLIGHT lotes aguardando gravação
+        windows = [deque() for _ in range(i, devices, BENCH_THREADS)]
+        while time.monotonic() < stop:
+            waiting = None
+            for window in windows:
+                while window and window[0].done():
+                    window.popleft()
+                    counts[i] += batch
+                if len(window) < BENCH_INFLIGHT:
+                    window.append(bench_writer.submit(rows))
+                elif waiting is None:
+                    waiting = window[0]
+            if waiting is not None:
+                waiting.result()
+        for window in windows:
+            for future in window:
+                future.result()
+                counts[i] += batch
+
+    print(f"{devices} dispositivos, lotes de {batch} linhas, {seconds:.0f} s por caso")
+    CSV_FILE = os.path.join(workdir, 'legacy.csv')
+    legacy = run("save_to_csv (abre/fecha por linha)", legacy_worker)
+    cases = [(CsvSink, 'writer.csv', policy) for policy in FSYNC_POLICIES]
+    cases += [(SegmentStore, SEGMENTS_DIR, policy) for policy in ('interval', 'commit')]
+    for sink, location, policy in cases:
+        bench_writer = RowWriter(sink(os.path.join(workdir, policy, location)), fsync=policy)
+        rate = run(f"RowWriter {sink.name} (fsync={policy})", writer_worker)
+        bench_writer.close()
+        print(f"{'':<36} {rate / legacy:>9.1f}x, {bench_writer.groups} grupos, "
+              f"{bench_writer.fsyncs} fsyncs, até {bench_writer.max_group} linhas/grupo")
+    shutil.rmtree(workdir, ignore_errors=True)
+
+# ==================== Agregados em memória por dispositivo (/status) ====================
+# Baldes circulares de tamanho fixo por dispositivo, atualizados a cada
+# amostra em O(1): último valor, contagem/min/max/soma por minuto e por hora
+# de cada canal e histograma de cores. A retenção (AGG_MINUTES minutos,
+# AGG_HOURS horas, AGG_MAX_DEVICES dispositivos) limita a memória; amostras
+# que chegam depois que o balde delas saiu da retenção (retransmissões
+# tardias) ficam fora dessa série e contam em 'late'
+AGG_MINUTES = 60
+AGG_HOURS = 24
+AGG_MAX_DEVICES = 1000
+
+class RollingBuckets:
+    """slots baldes de bucket_ms; o slot de um balde é (início / bucket_ms) % slots"""
+
+    def __init__(self, bucket_ms, slots):
+        self.bucket_ms = bucket_ms
+        self.slots = slots
+        self.starts = [None] * slots
+        self.stats = [None] * slots     # [linhas, min, max, soma de cada campo...]
+        self.colors = [None] * slots    # Contagem por índice de COLOR_NAMES
+
+    def add(self, sample):
+        """False se a amostra é mais antiga que o balde que ocupa o slot"""
+        start = sample[0] - sample[0] % self.bucket_ms
+        i = start // self.bucket_ms % self.slots
+        current = self.starts[i]
+        if current != start:
+            if current is not None and start < current:
+                return False
+            self.starts[i] = start
+            self.stats[i] = [0] + [0xFFFF, 0, 0] * len(ROLLUP_FIELDS)
+            self.colors[i] = [0] * len(COLOR_NAMES)
+        st = self.stats[i]
+        st[0] += 1
+        k = 1
+        for value in sample[2:]:
+            if value < st[k]:
+                st[k] = value
+            if value > st[k + 1]:
+                st[k + 1] = value
+            st[k + 2] += value
+            k += 3
+        self.colors[i][sample[1]] += 1
+        return True
+
+    def _item(self, i):
+        st = self.stats[i]
+        item = {'t': self.starts[i], 'count': st[0]}
+        for k, f in enumerate(ROLLUP_FIELDS):
+            lo, hi, total = st[1 + 3 * k:4 + 3 * k]
+            item[f] = {'min': lo, 'max': hi, 'mean': round(total / st[0], 2)}
+        item['colors'] = {COLOR_NAMES[c]: n for c, n in enumerate(self.colors[i]) if n}
+        return item
+
+    def current(self, now_ms):
+        """Balde em andamento, ou None se ainda não chegou amostra nele"""
+        start = now_ms - now_ms % self.bucket_ms
+        i = start // self.bucket_ms % self.slots
+        return self._item(i) if self.starts[i] == start else None
+
+    def snapshot(self, now_ms):
+        """Baldes dentro da retenção, do mais antigo ao atual"""
+        oldest = now_ms - now_ms % self.bucket_ms - (self.slots - 1) * self.bucket_ms
+        used = [i for i in range(self.slots)
+                if self.starts[i] is not None and self.starts[i] >= oldest]
+        return [self._item(i) for i in sorted(used, key=lambda i: self.starts[i])]
+
+class DeviceAggregates:
+    def __init__(self, minutes, hours):
+        self.last = None
+        self.last_seen = 0
+        self.samples = 0
+        self.late = 0
+        self.minutes = RollingBuckets(ROLLUP_MS, minutes)
+        self.hours = RollingBuckets(SEGMENT_MS, hours)
+
+    def add(self, sample, now_ms):
+        self.samples += 1
+        self.last_seen = now_ms
+        if self.last is None or sample[0] >= self.last[0]:
+            self.last = sample
+        in_minutes = self.minutes.add(sample)
+        if not self.hours.add(sample) or not in_minutes:
+            self.late += 1
+
+    def summary(self):
+        t, color_id, r, g, b, c, dist = self.last
+        return {'samples': self.samples, 'late': self.late, 'last_seen': self.last_seen,
+                'last': {'t': t, 'color': COLOR_NAMES[color_id], 'r': r, 'g': g, 'b': b,
+                         'c': c, 'dist': dist}}
+
+class Aggregates:
+    """Agregados de todos os dispositivos; o que ficou mais tempo calado sai primeiro"""
+
+    def __init__(self, minutes=AGG_MINUTES, hours=AGG_HOURS, max_devices=AGG_MAX_DEVICES):
+        self.minutes = minutes
+        self.hours = hours
+        self.max_devices = max_devices
+        self.devices = OrderedDict()    # id -> DeviceAggregates, do menos ao mais recente
+        self.evicted = 0
+        self.lock = threading.Lock()
+
+    def add(self, device, samples):
+        now_ms = int(time.time() * 1000)
+        with self.lock:
+            agg = self.devices.pop(device, None)
+            if agg is None:
+                if len(self.devices) >= self.max_devices:
+                    self.devices.popitem(last=False)
+                    self.evicted += 1
+                agg = DeviceAggregates(self.minutes, self.hours)
+            self.devices[device] = agg
+            for sample in samples:
+                agg.add(sample, now_ms)
+
+    def status(self, device=None):
+        """Resumo de todos; com device, as séries por minuto e por hora dele"""
+        now_ms = int(time.time() * 1000)
+        with self.lock:
+            if device is not None:
+                agg = self.devices.get(device)
+                if agg is None:
+                    return None
+                return dict(agg.summary(), device=device,
+                            minutes=agg.minutes.snapshot(now_ms),
+                            hours=agg.hours.snapshot(now_ms))
+            devices = {}
+            for name, agg in self.devices.items():
+                devices[name] = dict(agg.summary(), minute=agg.minutes.current(now_ms))
+            return {'retention': {'minutes': self.minutes, 'hours': self.hours,
+                                  'max_devices': self.max_devices},
+                    'evicted': self.evicted, 'devices': devices}
+
+aggregates = Aggregates()
+
+# ==================== Painel ao vivo (GET /live, Server-Sent Events) ====================
+# As rotas de ingestão só acrescentam ao anel de eventos (O(1), sem tocar nos
+# espectadores, e nada se ninguém está olhando). Cada espectador guarda um
+# cursor e lê o anel no próprio ritmo a cada LIVE_TICK_S: quem fica para trás
+# perde os eventos mais antigos, com aviso, e não atrasa a ingestão nem os
+# outros espectadores
+LIVE_BACKLOG = 512
+LIVE_REPLAY = 50        # Eventos recentes enviados ao conectar
+LIVE_TICK_S = 0.25
+LIVE_PING_S = 15        # Comentário SSE para manter a conexão com proxies
+LIVE_MAX_VIEWERS = 100
+
+class LiveFeed:
+    """Anel das últimas amostras recebidas, já formatadas como eventos SSE"""
+
+    def __init__(self, backlog=LIVE_BACKLOG):
+        self.events = deque(maxlen=backlog)
+        self.seq = 0
+        self.viewers = 0
+        self.dropped = 0
+        self.lock = threading.Lock()
+
+    def publish(self, samples, device=''):
+        if not self.viewers:
+            return
+        events = [json.dumps({'t': s[0], 'device': device, 'color': COLOR_NAMES[s[1]],
+                              'r': s[2], 'g': s[3], 'b': s[4], 'c': s[5], 'dist': s[6]})
+                  for s in samples]
+        with self.lock:
+            for data in events:
+                self.seq += 1
+                self.events.append(f"id: {self.seq}\ndata: {data}\n\n")
+
+    def read(self, cursor):
+        """Eventos depois de cursor: (novo cursor, texto, eventos perdidos)"""
+        with self.lock:
+            missed = self.seq - cursor
+            if missed <= 0:
+                return self.seq, '', 0
+            kept = min(missed, len(self.events))
+            self.dropped += missed - kept
+            text = ''.join(self.events[i] for i in range(len(self.events) - kept, len(self.events)))
+            return self.seq, text, missed - kept
+
+    def stats(self):
+        return {'viewers': self.viewers, 'events': self.seq, 'dropped': self.dropped}
+
+live = LiveFeed()
+
+class LiveStream:
+    """Resposta de /live: o servidor (Flask ou assíncrono) transmite os eventos"""
+
+    def __init__(self, feed):
+        self.feed = feed
+        self.cursor = max(feed.seq - LIVE_REPLAY, 0)
+        self.last_write = time.monotonic()
+
+    def _attach(self, delta):
+        with self.feed.lock:
+            self.feed.viewers += delta
+
+    def _chunk(self):
+        self.cursor, text, lost = self.feed.read(self.cursor)
+        if lost:
+            text = f"event: dropped\ndata: {lost}\n\n" + text
+        if not text and time.monotonic() - self.last_write >= LIVE_PING_S:
+            text = ": ping\n\n"
+        if text:
+            self.last_write = time.monotonic()
+        return text.encode()
+
+    async def serve_async(self, stream):
+        stream.write(b"HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                     b"Cache-Control: no-cache\r\nConnection: close\r\n\r\n")
+        self._attach(1)
+        try:
+            while not stream.is_closing():
+                chunk = self._chunk()
+                if chunk:
+                    stream.write(chunk)
+                    await stream.drain()
+                await asyncio.sleep(LIVE_TICK_S)
+        finally:
+            self._attach(-1)
+
+    def iter_sync(self):
+        self._attach(1)
+        try:
+            while True:
+                chunk = self._chunk()
+                if chunk:
+                    yield chunk
+                time.sleep(LIVE_TICK_S)
+        finally:
+            self._attach(-1)
+
+# ==================== Rotas (comuns ao Flask e ao modo assíncrono) ====================
+# Cada handler recebe (args, corpo) e devolve (corpo, status, content-type),
+# um Future com isso quando a resposta depende da gravação (ACK) ou um
+# LiveStream (/live)
+VERBOSE = True
+
+def text_response(body, status=200):
+    return body, status, 'text/plain'
+
+def json_response(obj, status=200):
+    return json.dumps(obj), status, 'application/json'
+
+def arg_int(args, key):
+    try:
+        return int(args[key])
+    except (KeyError, TypeError, ValueError):
+        return None
+
+def handle_data(args, body):
     """Endpoint para receber dados do Pico W"""
     try:
         # Extrair parâmetros
-        r = request.args.get('r', 0)
-        g = request.args.get('g', 0)
-        b = request.args.get('b', 0)
-        c = request.args.get('c', 0)
-        dist = request.args.get('dist', 0)
-        cor = request.args.get('cor', 'DESCONHECIDO')
+        r = args.get('r', 0)
+        g = args.get('g', 0)
+        b = args.get('b', 0)
+        c = args.get('c', 0)
+        dist = args.get('dist', 0)
+        cor = args.get('cor', 'DESCONHECIDO')
+        try:
+            device = parse_device(args.get('id'))
+        except ValueError as e:
+            return text_response(f"BAD DEVICE: {e}", 400)
+        reason = quotas.admit(device, 1, writer.pending_rows(device))
+        if reason:
+            return quota_response(device, reason)
         
         # Determinar estado do LED
-        try:
-            dist_int = int(dist)
-            led_estado = "VERMELHO" if dist_int < 150 else "VERDE"
-        except:
-            led_estado = "DESLIGADO"
+        led_estado = led_state(dist)
         
-        # Timestamp
-        timestamp = datetime.now().strftime('%Y-%m-%d %H:%M:%S')
+        # Timestamp: horário de captura do dispositivo (ts, ms UTC) se sincronizado
+        ts = arg_int(args, 'ts')
+        if ts is None or ts < EPOCH_MIN_MS:
+            ts = int(time.time() * 1000)
+        timestamp = datetime.fromtimestamp(ts / 1000).strftime('%Y-%m-%d %H:%M:%S')
         
         # Exibir no console
-        print("=" * 70)
-        print(f"📅 {timestamp}")
-        print(f"🎨 Cor Detectada: {cor}")
-        print(f"🔴 R: {r:>5}  🟢 G: {g:>5}  🔵 B: {b:>5}  ⚪ Clear: {c:>5}")
-        print(f"📏 Distância: {dist:>4} mm ({int(dist)/10:.1f} cm)")
-        print(f"💡 LED: {led_estado}")
-        print("=" * 70)
-        print()
-        
-        # Salvar em CSV
-        data_row = [timestamp, cor, r, g, b, c, dist, led_estado]
-        save_to_csv(data_row)
+        if VERBOSE:
+            print("=" * 70)
+            print(f"📅 {timestamp}" + (f"  📟 {device}" if device else ""))
+            print(f"🎨 Cor Detectada: {cor}")
+            print(f"🔴 R: {r:>5}  🟢 G: {g:>5}  🔵 B: {b:>5}  ⚪ Clear: {c:>5}")
+            print(f"📏 Distância: {dist:>4} mm ({int(dist)/10:.1f} cm)")
+            print(f"💡 LED: {led_estado}")
+            print("=" * 70)
+            print()
         
-        return "OK", 200
+        # Gravar (thread do writer)
+        color_id = COLOR_NAMES.index(cor) if cor in COLOR_NAMES else 0
+        sample = make_sample(ts, color_id, r, g, b, c, dist)
+        writer.submit([sample], on_written=stored(device, [sample]), device=device)
+        note_rows(1)
+
+        return text_response("\n".join(["OK"] + control_lines()) + "\n")
         
     except Exception as e:
         print(f"❌ Erro ao processar dados: {e}")
-        return "ERROR", 500
+        return text_response("ERROR", 500)
 
-@app.route('/')
-def index():
-    """Página inicial"""
-    return """
+def handle_batch(args, body):
+    """Endpoint para lotes binários (sample_codec.h)"""
+    try:
+        header, samples = decode_batch(body)
+    except ValueError as e:
+        print(f"❌ Lote inválido: {e}")
+        return text_response("BAD BATCH", 400)
+
+    # v2: descarta retransmissões já gravadas, mas responde o ACK de novo
+    key = None
+    if header['seq'] is not None:
+        key = AckState.key(header['device_id'], header['stream_id'])
+        reserved, acked, first = ack_state.reserve(key, header['seq'], header['base_seq'])
+        if not reserved:
+            if first is None:
+                print(f"♻️  Lote #{header['seq']} duplicado de {key} (ack={acked})")
+                return ack_response(acked, duplicate=True)
+            # Retransmissão chegou com a primeira cópia ainda na fila do
+            # writer: responde dup=1 com o ACK de depois da gravação dela
+            print(f"♻️  Lote #{header['seq']} de {key} já em gravação, aguardando")
+            return chain_future(first, lambda acked: ack_response(acked, duplicate=True))
+
+    device = header['device_id'].hex()
+    reason = quotas.admit(device, len(samples), writer.pending_rows(device))
+    if reason:
+        if key is not None:
+            ack_state.release(key, header['seq'], RuntimeError(f"cota: {reason}"))
+        return quota_response(device, reason)
+
+    # Dispositivo sincronizado (SNTP): usa o horário de captura. Senão os
+    # timestamps são relativos ao boot: ancora a última amostra no horário de
+    # chegada e preserva os intervalos entre amostras
+    now = datetime.now()
+    now_ms = int(now.timestamp() * 1000)
+    last_ts = samples[-1]['ts'] if samples else 0
+    synced = header['base_ts'] >= EPOCH_MIN_MS
+    rows = [make_sample(s['ts'] if synced else now_ms - (last_ts - s['ts']), s['color_id'],
+                        s['r'], s['g'], s['b'], s['c'], s['dist'])
+            for s in samples]
+
+    clock = "sem SNTP"
+    if synced and samples:
+        # Idade da amostra mais nova na chegada: batching + rede + erro do relógio
+        clock = f"idade {now_ms - last_ts} ms"
+    note_rows(len(samples))
+    if key is None:
+        writer.submit(rows, on_written=stored(device, rows), device=device)
+        if VERBOSE:
+            print(f"📦 {now.strftime('%Y-%m-%d %H:%M:%S')} lote de {len(samples)} amostras "
+                  f"do dispositivo {device} ({clock})")
+        return text_response("\n".join(["OK"] + control_lines()) + "\n")
+
+    # Persiste o ACK só depois das linhas gravadas
+    def commit():
+        acked = ack_state.commit(key, header['seq'], header['base_seq'])
+        if VERBOSE:
+            print(f"📦 {now.strftime('%Y-%m-%d %H:%M:%S')} lote #{header['seq']} de {len(samples)} "
+                  f"amostras do stream {key} ({clock}, ack={acked})")
+        return ack_response(acked)
+    written = writer.submit(rows, on_written=stored(device, rows, commit), device=device)
+    written.add_done_callback(
+        lambda f: f.exception() and ack_state.release(key, header['seq'], f.exception()))
+    return written
+
+def stored(device, rows, then=None):
+    """on_written do writer: agregados e /live só veem linhas já gravadas, e
+    uma retransmissão depois de falha na gravação não conta duas vezes"""
+    def on_written():
+        aggregates.add(device, rows)
+        live.publish(rows, device)
+        return then() if then else None
+    return on_written
+
+def chain_future(future, fn):
+    """Future com fn(resultado) quando future resolver (ou a mesma exceção)"""
+    chained = Future()
+    def done(f):
+        if f.exception() is not None:
+            chained.set_exception(f.exception())
+        else:
+            chained.set_result(fn(f.result()))
+    future.add_done_callback(done)
+    return chained
+
+def ack_response(acked, duplicate=False):
+    """Corpo "chave=valor" lido pelo firmware (uplink_response_get_uint)"""
+    lines = [f"ack={acked}"] if acked >= 0 else []
+    if duplicate:
+        lines.append("dup=1")
+    lines += control_lines()
+    return text_response("\n".join(lines) + "\n")
+
+def handle_control(args, body):
+    """Consulta/ajusta o controle da frota: /control?period_ms=5000&batch=8&delta=20"""
+    for key in control:
+        value = arg_int(args, key)
+        if value is not None:
+            control[key] = value
+    return json_response({**control, 'throttle_factor': throttle.factor if throttle else 1,
+                          'sent': control_lines()})
+
+def handle_fault(args, body):
+    """Consulta/ajusta a falha injetada: /fault?delay_ms=3000 ou /fault?fail=1"""
+    for key in fault:
+        value = arg_int(args, key)
+        if value is not None:
+            fault[key] = value
+    return json_response(dict(fault))
+
+INDEX_HTML = """
     <html>
     <head>
         <title>Servidor BitDogLab</title>
-        <meta http-equiv="refresh" content="2">
+        <meta charset="utf-8">
         <style>
             body {
                 font-family: Arial, sans-serif;
@@ -98,55 +1696,558 @@ def index():
                 border-radius: 5px;
                 margin: 10px 0;
             }
+            .status.off { background: #b71c1c; }
+            .now { display: flex; align-items: center; gap: 20px; margin: 15px 0; }
+            #swatch { width: 80px; height: 80px; border-radius: 10px; background: #444; }
+            #dist { font-size: 48px; }
+            canvas { width: 100%; height: 160px; background: #1e1e1e; border-radius: 5px; }
+            table { width: 100%; border-collapse: collapse; margin-top: 10px; }
+            td, th { padding: 4px 8px; border-bottom: 1px solid #444; text-align: left; }
         </style>
     </head>
     <body>
         <div class="container">
             <h1>🚀 Servidor BitDogLab - Sensor Data</h1>
-            <div class="status">
-                ✅ Servidor ativo e aguardando dados...
+            <div class="status" id="status">Conectando...</div>
+            <div class="now">
+                <div id="swatch"></div>
+                <div><div id="dist">-- mm</div><div id="color">--</div></div>
             </div>
-            <p>Endpoint: <code>/data</code></p>
-            <p>Dados salvos em: <code>sensor_data.csv</code></p>
-            <p>Esta página atualiza automaticamente a cada 2 segundos.</p>
+            <canvas id="chart" width="760" height="160"></canvas>
+            <table>
+                <thead><tr><th>Dispositivo</th><th>Cor</th><th>Distância</th><th>RGB</th><th>Última</th></tr></thead>
+                <tbody id="devices"></tbody>
+            </table>
+            <p>Ingestão: <code>/data</code>, <code>/batch</code>. Eventos: <code>/live</code>.
+               Histórico: <code>/query</code>. Dados em <code>segments/</code>
+               (<code>--storage csv</code>: <code>sensor_data.csv</code>)</p>
         </div>
+        <script>
+            const CSS = {PRETO: '#000', BRANCO: '#fff', VERMELHO: '#e53935', VERDE: '#43a047',
+                         AZUL: '#1e88e5', AMARELO: '#fdd835', CIANO: '#00bcd4', MAGENTA: '#d81b60',
+                         LARANJA: '#fb8c00', CINZA: '#9e9e9e', MARROM: '#6d4c41'};
+            const MAX_POINTS = 300;
+            const points = [];
+            const devices = {};
+            const chart = document.getElementById('chart').getContext('2d');
+            let pending = false;
+
+            function draw() {
+                pending = false;
+                const w = chart.canvas.width, h = chart.canvas.height;
+                chart.clearRect(0, 0, w, h);
+                if (points.length < 2) return;
+                const max = Math.max(...points, 1);
+                chart.strokeStyle = '#4CAF50';
+                chart.beginPath();
+                points.forEach((d, i) => {
+                    const x = i * w / (MAX_POINTS - 1), y = h - 4 - d * (h - 8) / max;
+                    i ? chart.lineTo(x, y) : chart.moveTo(x, y);
+                });
+                chart.stroke();
+                chart.fillStyle = '#aaa';
+                chart.fillText(max + ' mm', 4, 12);
+
+                document.getElementById('devices').innerHTML = Object.entries(devices).map(([id, s]) =>
+                    `<tr><td>${id || '(GET /data)'}</td><td>${s.color}</td><td>${s.dist} mm</td>` +
+                    `<td>${s.r}, ${s.g}, ${s.b}</td><td>${new Date(s.t).toLocaleTimeString()}</td></tr>`).join('');
+            }
+
+            const source = new EventSource('/live');
+            const status = document.getElementById('status');
+            source.onopen = () => { status.className = 'status'; status.textContent = '✅ Recebendo ao vivo'; };
+            source.onerror = () => { status.className = 'status off'; status.textContent = '⚠️ Reconectando...'; };
+            source.addEventListener('dropped', e => console.warn('eventos perdidos:', e.data));
+            source.onmessage = e => {
+                const s = JSON.parse(e.data);
+                devices[s.device] = s;
+                points.push(s.dist);
+                if (points.length > MAX_POINTS) points.shift();
+                document.getElementById('dist').textContent = s.dist + ' mm';
+                document.getElementById('color').textContent = s.color;
+                document.getElementById('swatch').style.background = CSS[s.color] || '#444';
+                // Um redesenho por quadro, mesmo com rajadas de eventos
+                if (!pending) { pending = true; requestAnimationFrame(draw); }
+            };
+        </script>
     </body>
     </html>
     """
 
-@app.route('/status')
-def status():
-    """Status do servidor"""
-    return {
+def handle_live(args, body):
+    """Amostras novas em tempo real (text/event-stream)"""
+    if live.viewers >= LIVE_MAX_VIEWERS:
+        return text_response("TOO MANY VIEWERS", 503)
+    return LiveStream(live)
+
+def handle_index(args, body):
+    """Página inicial"""
+    return INDEX_HTML, 200, 'text/html; charset=utf-8'
+
+def handle_status(args, body):
+    """Status do servidor; /status?device=ID traz as séries por minuto e hora do dispositivo"""
+    if 'device' in args:
+        detail = aggregates.status(args['device'])
+        if detail is None:
+            return json_response({'error': f"dispositivo desconhecido: {args['device']}"}, 404)
+        return json_response(detail)
+    return json_response({
         "status": "online",
         "timestamp": datetime.now().isoformat(),
-        "csv_file": CSV_FILE,
-        "file_exists": os.path.exists(CSV_FILE)
-    }
+        "storage": writer.sink.name,
+        "location": writer.sink.location,
+        "writer": writer.stats(),
+        "live": live.stats(),
+        "aggregates": aggregates.status(),
+        "ingest": quotas.status(),
+    })
+
+query_pool = ThreadPoolExecutor(QUERY_WORKERS, thread_name_prefix='query')
+
+def query_directory(device):
+    """Diretório de segmentos do dispositivo ('' = sem ID); None se não houver"""
+    try:
+        directory = device_directory(writer.sink.directory, parse_device(device))
+    except ValueError:
+        return None
+    return directory if os.path.isdir(directory) else None
+
+def handle_query(args, body):
+    """Agregados por intervalo: /query?from=...&to=...&bucket=5m&fields=dist,r"""
+    if not isinstance(writer.sink, SegmentStore):
+        return json_response({'error': 'consulta requer --storage segments'}, 501)
+    device = args.get('device', '').lower()
+    directory = query_directory(device)
+    if directory is None:
+        return json_response({'error': f'dispositivo desconhecido: {device}'}, 404)
+    try:
+        to_ms = parse_time_arg(args.get('to')) or int(time.time() * 1000)
+        from_ms = parse_time_arg(args.get('from'))
+        if from_ms is None:
+            from_ms = to_ms - QUERY_DEFAULT_MS
+        fields = tuple(f for f in args.get('fields', ','.join(ROLLUP_FIELDS)).split(',') if f)
+        if 'bucket' in args:
+            bucket_ms = parse_duration_ms(args['bucket'])
+        else:
+            bucket_ms = next((b for b in QUERY_BUCKETS_MS
+                              if (to_ms - from_ms) / b <= QUERY_AUTO_BUCKETS), QUERY_BUCKETS_MS[-1])
+    except ValueError as e:
+        return json_response({'error': f'from/to/bucket inválido: {e}'}, 400)
+    if any(f not in ROLLUP_FIELDS for f in fields) or not fields:
+        return json_response({'error': f'fields: use {",".join(ROLLUP_FIELDS)}'}, 400)
+    if to_ms <= from_ms or bucket_ms <= 0:
+        return json_response({'error': 'intervalo ou balde vazio'}, 400)
+    if (to_ms - from_ms) / bucket_ms > QUERY_MAX_BUCKETS:
+        return json_response({'error': f'mais de {QUERY_MAX_BUCKETS} baldes'}, 400)
+
+    # Leitura de disco fora do loop assíncrono (e sem segurar o Flask além da conta)
+    def run():
+        started = time.perf_counter()
+        buckets, scanned = query_range(directory, from_ms, to_ms, bucket_ms, fields)
+        return json_response({
+            'device': device, 'from': from_ms, 'to': to_ms, 'bucket_ms': bucket_ms,
+            'fields': list(fields), 'buckets': buckets, 'scanned': scanned,
+            'elapsed_ms': round((time.perf_counter() - started) * 1000, 1),
+        })
+    return query_pool.submit(run)
+
+ROUTES = {
+    ('GET', '/data'): handle_data,
+    ('POST', '/batch'): handle_batch,
+    ('GET', '/control'): handle_control,
+    ('GET', '/fault'): handle_fault,
+    ('GET', '/'): handle_index,
+    ('GET', '/status'): handle_status,
+    ('GET', '/query'): handle_query,
+    ('GET', '/live'): handle_live,
+}
+
+def call_route(handler, path, args, body):
+    """Executa a rota bloqueando (Flask): falha injetada e espera da gravação"""
+    if path in FAULT_PATHS:
+        if fault['delay_ms'] > 0:
+            time.sleep(fault['delay_ms'] / 1000)
+        if fault['fail']:
+            return text_response("FAULT", 503)
+    response = handler(args, body)
+    return response.result() if isinstance(response, Future) else response
+
+if Flask:
+    app = Flask(__name__)
+
+    def _flask_view(handler):
+        def view():
+            response = call_route(handler, request.path, request.args.to_dict(),
+                                  request.get_data())
+            if isinstance(response, LiveStream):
+                return Response(response.iter_sync(), mimetype='text/event-stream',
+                                headers={'Cache-Control': 'no-cache'})
+            body, status, content_type = response
+            return body, status, {'Content-Type': content_type}
+        return view
+
+    for (method, path), handler in ROUTES.items():
+        app.add_url_rule(path, handler.__name__, _flask_view(handler), methods=[method])
+
+# ==================== Servidor assíncrono (--async) ====================
+# Uma corrotina por conexão; parse do HTTP/1.1 direto do stream e gravação
+# na thread do writer. Meta: ASYNC_TARGET_RPS lotes de 8 amostras por
+# segundo (~6000 dispositivos com leitura a cada 1,5 s), medida com --bench
+# com servidor e dispositivos emulados dividindo o mesmo processo
+ASYNC_TARGET_RPS = 500
+MAX_HEADER_BYTES = 8192
+MAX_BODY_BYTES = 65536
+HTTP_REASONS = {200: 'OK', 400: 'Bad Request', 404: 'Not Found', 405: 'Method Not Allowed',
+                413: 'Payload Too Large', 429: 'Too Many Requests', 500: 'Internal Server Error',
+                501: 'Not Implemented', 503: 'Service Unavailable'}
+
+async_stats = {'requests': 0, 'errors': 0}
+
+async def call_route_async(handler, path, args, body):
+    if path in FAULT_PATHS:
+        if fault['delay_ms'] > 0:
+            await asyncio.sleep(fault['delay_ms'] / 1000)
+        if fault['fail']:
+            return text_response("FAULT", 503)
+    response = handler(args, body)
+    if isinstance(response, Future):
+        response = await asyncio.wrap_future(response)
+    return response
+
+def encode_response(response, keep_alive):
+    body, status, content_type = response
+    if isinstance(body, str):
+        body = body.encode()
+    head = (f"HTTP/1.1 {status} {HTTP_REASONS.get(status, 'Unknown')}\r\n"
+            f"Content-Type: {content_type}\r\n"
+            f"Content-Length: {len(body)}\r\n"
+            f"Connection: {'keep-alive' if keep_alive else 'close'}\r\n\r\n")
+    return head.encode() + body
+
+async def handle_connection(reader, stream):
+    try:
+        while True:
+            try:
+                head = await reader.readuntil(b'\r\n\r\n')
+            except asyncio.IncompleteReadError:
+                break
+            except asyncio.LimitOverrunError:
+                stream.write(encode_response(text_response("HEADER TOO LARGE", 413), False))
+                break
+
+            lines = head.decode('latin-1').split('\r\n')
+            try:
+                method, target, version = lines[0].split(' ', 2)
+            except ValueError:
+                stream.write(encode_response(text_response("BAD REQUEST", 400), False))
+                break
+            headers = {}
+            for line in lines[1:]:
+                name, sep, value = line.partition(':')
+                if sep:
+                    headers[name.strip().lower()] = value.strip()
+
+            length = headers.get('content-length', '0') or '0'
+            if not length.isdigit() or not length.isascii():
+                # "abc", "-5", "+5": int()/readexactly() levantariam sem resposta
+                stream.write(encode_response(text_response("BAD CONTENT-LENGTH", 400), False))
+                break
+            length = int(length)
+            if length > MAX_BODY_BYTES:
+                stream.write(encode_response(text_response("BODY TOO LARGE", 413), False))
+                break
+            body = await reader.readexactly(length) if length else b''
+
+            url = urlsplit(target)
+            handler = ROUTES.get((method, url.path))
+            async_stats['requests'] += 1
+            if handler:
+                # Parâmetros vazios (?device=) ficam, como no Flask
+                args = dict(parse_qsl(url.query, keep_blank_values=True))
+                try:
+                    response = await call_route_async(handler, url.path, args, body)
+                except Exception as e:
+                    print(f"❌ Erro em {method} {url.path}: {e}")
+                    response = text_response("ERROR", 500)
+                if isinstance(response, LiveStream):
+                    await response.serve_async(stream)
+                    break
+            elif any(path == url.path for _, path in ROUTES):
+                response = text_response("METHOD NOT ALLOWED", 405)
+            else:
+                response = text_response("NOT FOUND", 404)
+            if response[1] >= 400:
+                async_stats['errors'] += 1
+
+            keep_alive = version == 'HTTP/1.1' and headers.get('connection', '').lower() != 'close'
+            stream.write(encode_response(response, keep_alive))
+            await stream.drain()
+            if not keep_alive:
+                break
+    except (ConnectionError, asyncio.IncompleteReadError):
+        pass
+    finally:
+        stream.close()
+
+async def start_async_server(host, port):
+    return await asyncio.start_server(handle_connection, host, port,
+                                      limit=MAX_HEADER_BYTES, backlog=1024)
+
+async def log_throughput(interval=10):
+    """Uma linha a cada intervalo no lugar do banner por amostra"""
+    last_requests, last_rows = 0, 0
+    while True:
+        await asyncio.sleep(interval)
+        requests, rows = async_stats['requests'], writer.rows_written
+        if requests != last_requests:
+            print(f"📈 {(requests - last_requests) / interval:.0f} req/s, "
+                  f"{(rows - last_rows) / interval:.0f} linhas/s, "
+                  f"fila {writer.pending()}, erros {async_stats['errors']}")
+        last_requests, last_rows = requests, rows
+
+async def serve_async(host, port):
+    server = await start_async_server(host, port)
+    asyncio.get_running_loop().create_task(log_throughput())
+    async with server:
+        await server.serve_forever()
+
+# ==================== Benchmark do modo assíncrono (--bench) ====================
+BENCH_BATCH = 8
+# Cotas do bench: altas o bastante para nunca recusar (o admit() continua no
+# caminho); o bench mede a ingestão, não a resposta 429
+BENCH_QUOTA_UNLIMITED = 1 << 40
+
+async def bench_device(port, index, deadline, latencies, totals):
+    """Um dispositivo emulado: lotes v2 em sequência, uma conexão por lote"""
+    device_id = index.to_bytes(DEVICE_ID_LEN, 'big')
+    seq = 0
+    while time.monotonic() < deadline:
+        now_ms = int(time.time() * 1000)
+        samples = [{'ts': now_ms - (BENCH_BATCH - i) * 100, 'r': 100 + i, 'g': 200, 'b': 300,
+                    'c': 900, 'dist': 100 + seq % 500, 'color_id': 3}
+                   for i in range(BENCH_BATCH)]
+        body = encode_batch(samples, device_id, stream_id=1, seq=seq, base_seq=seq)
+        request_head = (f"POST /batch HTTP/1.1\r\nHost: bench\r\n"
+                        f"Content-Type: application/octet-stream\r\n"
+                        f"Content-Length: {len(body)}\r\nConnection: close\r\n\r\n")
+        start = time.perf_counter()
+        try:
+            reader, stream = await asyncio.open_connection('127.0.0.1', port)
+            stream.write(request_head.encode() + body)
+            await stream.drain()
+            response = await reader.read()
+            stream.close()
+        except OSError:
+            totals['failed'] += 1
+            continue
+        latencies.append(time.perf_counter() - start)
+        if response.startswith(b'HTTP/1.1 200'):
+            totals['ok'] += 1
+            seq += 1
+        else:
+            totals['failed'] += 1
+
+def run_bench(devices, seconds, storage='segments', **writer_options):
+    """Servidor assíncrono + N dispositivos emulados no mesmo processo"""
+    global ack_state, writer, quotas, VERBOSE
+    workdir = tempfile.mkdtemp(prefix='bench_')
+    ack_state = AckState(os.path.join(workdir, 'ack_state.json'))
+    quotas = IngestQuotas(BENCH_QUOTA_UNLIMITED, BENCH_QUOTA_UNLIMITED, BENCH_QUOTA_UNLIMITED)
+    writer = RowWriter(open_storage(storage, workdir), **writer_options)
+    VERBOSE = False
+
+    latencies = []
+    totals = {'ok': 0, 'failed': 0}
+
+    async def bench():
+        server = await start_async_server('127.0.0.1', 0)
+        port = server.sockets[0].getsockname()[1]
+        deadline = time.monotonic() + seconds
+        await asyncio.gather(*(bench_device(port, i, deadline, latencies, totals)
+                               for i in range(devices)))
+        server.close()
+        await server.wait_closed()
+
+    start = time.monotonic()
+    asyncio.run(bench())
+    elapsed = time.monotonic() - start
+    writer.close()
+
+    if storage == 'csv':
+        stored = 0
+        for name in os.listdir(workdir):
+            if name.endswith('.csv'):
+                with open(os.path.join(workdir, name)) as f:
+                    stored += sum(1 for _ in f) - 1
+    else:
+        root = writer.sink.location
+        stored = sum(index['rows'] for device in list_devices(root)
+                     for index in list_segments(device_directory(root, device)))
+    shutil.rmtree(workdir, ignore_errors=True)
+
+    rps = totals['ok'] / elapsed
+    latencies.sort()
+    p50 = latencies[len(latencies) // 2] * 1000 if latencies else 0
+    p99 = latencies[int(len(latencies) * 0.99)] * 1000 if latencies else 0
+    print(f"Dispositivos: {devices}, duração: {elapsed:.1f} s")
+    print(f"Lotes: {totals['ok']} OK, {totals['failed']} falhas")
+    print(f"Vazão: {rps:.0f} lotes/s, {rps * BENCH_BATCH:.0f} linhas/s "
+          f"({stored} linhas gravadas em {storage})")
+    print(f"Latência: p50 {p50:.1f} ms, p99 {p99:.1f} ms")
+    print(f"Gravação: {writer.groups} grupos (até {writer.max_group} linhas), "
+          f"{writer.fsyncs} fsyncs (fsync={writer.fsync})")
+    # Qualquer falha reprova: sem cotas, toda requisição deveria ser aceita
+    ok = (rps >= ASYNC_TARGET_RPS and totals['failed'] == 0 and
+          stored == totals['ok'] * BENCH_BATCH)
+    print(f"Meta {ASYNC_TARGET_RPS} lotes/s: {'OK' if ok else 'NÃO atingida'}")
+    return 0 if ok else 1
 
 if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Servidor HTTP BitDogLab")
+    parser.add_argument('--port', type=int, default=5000,
+                        help="porta HTTP (padrão: 5000)")
+    parser.add_argument('--data-dir', default='.',
+                        help="diretório dos dados e do estado de ACK (um por servidor "
+                             "ao rodar vários na mesma máquina)")
+    parser.add_argument('--storage', choices=('segments', 'csv'), default='segments',
+                        help="segments: colunar por hora em DATA_DIR/segments (padrão); "
+                             "csv: sensor_data.csv como antes")
+    parser.add_argument('--export-csv', metavar='ARQUIVO',
+                        help="exporta os segmentos para CSV (formato antigo) e sai")
+    parser.add_argument('--from', dest='from_time', metavar='INICIO',
+                        help="início do --export-csv: ms desde 1970 ou '2026-10-19 05:00'")
+    parser.add_argument('--to', dest='to_time', metavar='FIM',
+                        help="fim (exclusivo) do --export-csv")
+    parser.add_argument('--device', metavar='ID',
+                        help="dispositivo do --export-csv (padrão: amostras sem ID)")
+    parser.add_argument('--delay-ms', type=int, default=0,
+                        help="atraso artificial em /data e /batch (ajustável em /fault)")
+    parser.add_argument('--async', dest='async_mode', action='store_true',
+                        help="servidor assíncrono (muitos dispositivos; padrão sem Flask)")
+    parser.add_argument('--verbose', action='store_true',
+                        help="no modo assíncrono, imprime cada amostra como o modo Flask")
+    parser.add_argument('--bench', action='store_true',
+                        help="mede a vazão do modo assíncrono com dispositivos emulados e sai")
+    parser.add_argument('--bench-devices', type=int, default=50,
+                        help="dispositivos emulados no --bench (padrão: 50)")
+    parser.add_argument('--bench-seconds', type=float, default=10,
+                        help="duração do --bench (padrão: 10 s)")
+    parser.add_argument('--flush-rows', type=int, default=256,
+                        help="grava o grupo ao juntar N linhas (padrão: 256)")
+    parser.add_argument('--flush-ms', type=int, default=50,
+                        help="ou quando a primeira linha pendente tiver N ms (padrão: 50)")
+    parser.add_argument('--fsync', choices=FSYNC_POLICIES, default='interval',
+                        help="never | interval (padrão) | commit: fsync antes de cada ACK "
+                             "(linhas e ack_state.json)")
+    parser.add_argument('--fsync-interval-s', type=float, default=1.0,
+                        help="intervalo mínimo entre fsyncs em --fsync interval (padrão: 1 s)")
+    parser.add_argument('--writer-bench', action='store_true',
+                        help="compara linhas/s de save_to_csv e do RowWriter e sai")
+    parser.add_argument('--codec-report', metavar='CSV', nargs='?', const='',
+                        help="compara ASCII vs lotes binários, valida round-trip e fuzz "
+                             "do decodificador e sai; sem CSV usa amostras sintéticas")
+    parser.add_argument('--batch-size', type=int, default=8,
+                        help="amostras por lote no --codec-report e no --writer-bench (padrão: 8)")
+    parser.add_argument('--period-ms', type=int, default=control['period_ms'],
+                        help="período de amostragem pedido à frota (padrão: 1500)")
+    parser.add_argument('--batch', type=int, default=control['batch'],
+                        help="amostras por lote pedidas à frota (padrão: 8)")
+    parser.add_argument('--delta', type=int, default=control['delta'],
+                        help="report-on-change: mudança mínima para reportar (0 = tudo)")
+    parser.add_argument('--max-rows-per-s', type=float, metavar='N',
+                        help="dobra o período da frota enquanto a ingestão passar de N linhas/s")
+    parser.add_argument('--device-max-rows-per-s', type=float, default=DEVICE_MAX_ROWS_PER_S,
+                        help="cota de linhas/s de cada dispositivo (acima: 429)")
+    parser.add_argument('--device-burst-rows', type=int, default=DEVICE_BURST_ROWS,
+                        help="rajada acumulável da cota de cada dispositivo")
+    parser.add_argument('--device-queue-rows', type=int, default=DEVICE_QUEUE_ROWS,
+                        help="linhas de um dispositivo aguardando gravação (acima: 429)")
+    parser.add_argument('--agg-minutes', type=int, default=AGG_MINUTES,
+                        help="minutos mantidos nos agregados em memória de /status")
+    parser.add_argument('--agg-hours', type=int, default=AGG_HOURS,
+                        help="horas mantidas nos agregados em memória de /status")
+    parser.add_argument('--agg-devices', type=int, default=AGG_MAX_DEVICES,
+                        help="dispositivos nos agregados (sai o calado há mais tempo)")
+    parser.add_argument('--ntp-port', type=int, metavar='PORTA',
+                        help="também responde SNTP nesta porta UDP (123 exige root; "
+                             "compile o firmware com -DSNTP_PORT=PORTA)")
+    args = parser.parse_args()
+
+    if args.codec_report is not None:
+        codec_report(args.codec_report, args.batch_size)
+        raise SystemExit(0)
+    if args.export_csv:
+        segments = device_directory(os.path.join(args.data_dir, SEGMENTS_DIR),
+                                    parse_device(args.device))
+        rows = export_csv(segments, args.export_csv,
+                          parse_time_arg(args.from_time), parse_time_arg(args.to_time))
+        print(f"{rows} linhas exportadas para {args.export_csv}")
+        raise SystemExit(0)
+    if args.bench:
+        raise SystemExit(run_bench(args.bench_devices, args.bench_seconds, args.storage,
+                                   flush_rows=args.flush_rows, flush_ms=args.flush_ms,
+                                   fsync=args.fsync, fsync_interval_s=args.fsync_interval_s))
+    if args.writer_bench:
+        writer_bench(args.bench_devices, args.bench_seconds, args.batch_size)
+        raise SystemExit(0)
+    if not Flask and not args.async_mode:
+        print("Flask não instalado: usando o modo assíncrono")
+        args.async_mode = True
+
+    control.update(period_ms=args.period_ms, batch=args.batch, delta=args.delta)
+    fault['delay_ms'] = args.delay_ms
+    os.makedirs(args.data_dir, exist_ok=True)
+    ACK_STATE_FILE = os.path.join(args.data_dir, ACK_STATE_FILE)
+    if args.max_rows_per_s:
+        throttle = Throttle(args.max_rows_per_s)
+    aggregates = Aggregates(max(args.agg_minutes, 1), max(args.agg_hours, 1),
+                            max(args.agg_devices, 1))
+    quotas = IngestQuotas(args.device_max_rows_per_s, args.device_burst_rows,
+                          args.device_queue_rows)
+
     print()
     print("=" * 70)
     print("  🌐 Servidor HTTP BitDogLab - Receptor de Dados dos Sensores")
     print("=" * 70)
     print()
-    print("📡 Escutando em: http://0.0.0.0:5000")
-    print("📊 Endpoint de dados: http://0.0.0.0:5000/data")
-    print("💾 Salvando dados em:", CSV_FILE)
+    print(f"📡 Escutando em: http://0.0.0.0:{args.port}")
+    print(f"📊 Endpoint de dados: http://0.0.0.0:{args.port}/data")
+    print(f"🎛️  Controle da frota: http://0.0.0.0:{args.port}/control", control)
+    if fault['delay_ms']:
+        print(f"🐢 Atraso injetado: {fault['delay_ms']} ms")
+    storage = open_storage(args.storage, args.data_dir)
+    print("💾 Salvando dados em:", storage.location)
+    print("⚡ Modo:", "assíncrono" if args.async_mode else "Flask")
     print()
     print("⚙️  Configure o Pico W com:")
     print("   SERVER_IP = [SEU_IP_LOCAL]")
-    print("   SERVER_PORT = 5000")
+    print(f"   SERVER_PORT = {args.port}")
     print()
+    if args.ntp_port:
+        threading.Thread(target=ntp_standin, args=(args.ntp_port,), daemon=True).start()
+        print(f"🕒 Stand-in NTP em udp://0.0.0.0:{args.ntp_port}")
+        print()
     print("🛑 Pressione Ctrl+C para parar o servidor")
     print("=" * 70)
     print()
     
-    # Inicializar CSV
-    init_csv()
+    # Estado de ACK (sobrevive a reinícios do servidor) e gravação
+    ack_state = AckState(ACK_STATE_FILE, fsync=args.fsync == 'commit',
+                         save_interval_s=0 if args.fsync == 'commit' else ACK_STATE_SAVE_S)
+    writer = RowWriter(storage, flush_rows=args.flush_rows, flush_ms=args.flush_ms,
+                       fsync=args.fsync, fsync_interval_s=args.fsync_interval_s)
     
     # Iniciar servidor
     try:
-        app.run(host='0.0.0.0', port=5000, debug=False)
+        if args.async_mode:
+            VERBOSE = args.verbose
+            asyncio.run(serve_async('0.0.0.0', args.port))
+        else:
+            app.run(host='0.0.0.0', port=args.port, debug=False)
     except KeyboardInterrupt:
         print("\n\n👋 Servidor encerrado pelo usuário")
+    finally:
+        # Grupo pendente e fsync final antes de sair
+        writer.close()
+        ack_state.flush()
+        print(f"💾 {writer.rows_written} linhas gravadas em {writer.groups} grupos")
@@ -0,0 +1,217 @@
+/**
+ * Seleção do servidor de ingestão
+ *
+ * Mantém RTT e taxa de falhas por servidor a partir das respostas do uplink
+ * e escolhe o de menor custo a cada envio. Um servidor com requisição parada
+ * além do esperado para o seu RTT deixa de receber envios na hora, sem
+ * esperar o timeout; falhas seguidas o tiram da rotação até um teste
+ * periódico responder. Acessada pelo http_task e pelo callback do uplink
+ * (contexto do lwIP).
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "server_pool.h"
+#include "uplink.h"
+
+// Travamento nunca espera mais que meio timeout de requisição
+#define SERVER_POOL_STALL_MAX_MS    (UPLINK_TIMEOUT_MS / 2)
+
+static server_endpoint_t endpoints[SERVER_POOL_MAX];
+static server_pool_stats_t stats = { .current = -1 };
+static uint32_t picks = 0;
+
+void server_pool_init(void) {
+    taskENTER_CRITICAL();
+    stats = (server_pool_stats_t){ .current = -1 };
+    picks = 0;
+    taskEXIT_CRITICAL();
+}
+
+bool server_pool_add(const char *ip, uint16_t port) {
+    ip_addr_t addr;
+    if (stats.count >= SERVER_POOL_MAX || !ipaddr_aton(ip, &addr)) {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    server_endpoint_t *e = &endpoints[stats.count];
+    *e = (server_endpoint_t){
+        .addr = addr,
+        .port = port,
+        .rtt_ewma_ms = SERVER_POOL_RTT_INIT_MS,
+    };
+    stats.count++;
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+static bool endpoint_stalled(const server_endpoint_t *e, uint32_t now_ms) {
+    if (!e->in_flight) {
+        return false;
+    }
+    uint32_t limit = e->rtt_ewma_ms * 4;
+    if (limit < SERVER_POOL_STALL_MIN_MS) {
+        limit = SERVER_POOL_STALL_MIN_MS;
+    } else if (limit > SERVER_POOL_STALL_MAX_MS) {
+        limit = SERVER_POOL_STALL_MAX_MS;
+    }
+    return now_ms - e->pending_since_ms >= limit;
+}
+
+// RTT médio penalizado pela taxa de falhas (100% de falhas = 5x) e pela
+// fila já em curso no servidor
+static uint64_t endpoint_cost(const server_endpoint_t *e) {
+    return (uint64_t)e->rtt_ewma_ms * (1000 + 4 * e->fail_permille) * (2 + e->in_flight);
+}
+
+static int choose(uint32_t now_ms) {
+    int best = -1;
+
+    // Servidor fora da rotação: uma requisição de teste por período
+    for (int i = 0; i < (int)stats.count; i++) {
+        server_endpoint_t *e = &endpoints[i];
+        if (e->down && now_ms - e->down_since_ms >= SERVER_POOL_PROBE_MS) {
+            e->down_since_ms = now_ms;
+            stats.probes++;
+            return i;
+        }
+    }
+
+    // Exploração: mede de vez em quando o saudável há mais tempo sem envio
+    if (stats.count > 1 && ++picks % SERVER_POOL_EXPLORE_EVERY == 0) {
+        for (int i = 0; i < (int)stats.count; i++) {
+            const server_endpoint_t *e = &endpoints[i];
+            if (i == stats.current || e->down || endpoint_stalled(e, now_ms)) {
+                continue;
+            }
+            if (best < 0 || (int32_t)(e->last_pick_ms - endpoints[best].last_pick_ms) < 0) {
+                best = i;
+            }
+        }
+        if (best >= 0) {
+            stats.explores++;
+            return best;
+        }
+    }
+
+    // Menor custo entre os saudáveis
+    for (int i = 0; i < (int)stats.count; i++) {
+        const server_endpoint_t *e = &endpoints[i];
+        if (e->down || endpoint_stalled(e, now_ms)) {
+            continue;
+        }
+        if (best < 0 || endpoint_cost(e) < endpoint_cost(&endpoints[best])) {
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        return best;
+    }
+
+    // Nenhum saudável: o travado de menor custo, senão o que caiu há mais tempo
+    for (int i = 0; i < (int)stats.count; i++) {
+        const server_endpoint_t *e = &endpoints[i];
+        if (!e->down && (best < 0 || endpoint_cost(e) < endpoint_cost(&endpoints[best]))) {
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        return best;
+    }
+    for (int i = 0; i < (int)stats.count; i++) {
+        if (best < 0 || (int32_t)(endpoints[i].down_since_ms - endpoints[best].down_since_ms) < 0) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+int server_pool_pick(uint32_t now_ms) {
+    taskENTER_CRITICAL();
+    int index = choose(now_ms);
+    if (index >= 0) {
+        if (stats.current >= 0 && index != stats.current) {
+            const server_endpoint_t *prev = &endpoints[stats.current];
+            if (prev->down || endpoint_stalled(prev, now_ms)) {
+                stats.failovers++;
+            }
+        }
+        server_endpoint_t *e = &endpoints[index];
+        if (!e->in_flight) {
+            e->pending_since_ms = now_ms;
+        }
+        e->in_flight++;
+        e->requests++;
+        e->last_pick_ms = now_ms;
+        stats.current = index;
+    }
+    taskEXIT_CRITICAL();
+    return index;
+}
+
+void server_pool_cancel(int index) {
+    if (index < 0 || index >= (int)stats.count) {
+        return;
+    }
+    taskENTER_CRITICAL();
+    server_endpoint_t *e = &endpoints[index];
+    if (e->in_flight) {
+        e->in_flight--;
+        e->requests--;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void server_pool_result(const ip_addr_t *addr, uint16_t port, bool ok,
+                        uint32_t latency_ms, uint32_t now_ms) {
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0; i < stats.count; i++) {
+        server_endpoint_t *e = &endpoints[i];
+        if (e->port != port || !ip_addr_cmp(&e->addr, addr)) {
+            continue;
+        }
+
+        if (e->in_flight) {
+            e->in_flight--;
+        }
+        e->pending_since_ms = now_ms;
+        if (ok) {
+            // De volta à rotação: o RTT inflado pelos timeouts não vale mais
+            if (e->down) {
+                e->rtt_ewma_ms = latency_ms;
+                e->down = false;
+            }
+            e->consecutive_fails = 0;
+            e->fail_permille -= e->fail_permille / 8;
+        } else {
+            e->failures++;
+            e->consecutive_fails++;
+            e->fail_permille += (1000 - e->fail_permille) / 8;
+            // Conexão recusada responde rápido: não pode parecer um servidor bom
+            if (latency_ms < e->rtt_ewma_ms) {
+                latency_ms = e->rtt_ewma_ms;
+            }
+            if (!e->down && e->consecutive_fails >= SERVER_POOL_DOWN_FAILS) {
+                e->down = true;
+                e->down_since_ms = now_ms;
+            }
+        }
+        e->rtt_ewma_ms = e->rtt_ewma_ms + ((int32_t)(latency_ms - e->rtt_ewma_ms) / 4);
+        break;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void server_pool_get(int index, server_endpoint_t *out) {
+    taskENTER_CRITICAL();
+    *out = endpoints[index];
+    taskEXIT_CRITICAL();
+}
+
+void server_pool_get_stats(server_pool_stats_t *out) {
+    taskENTER_CRITICAL();
+    *out = stats;
+    taskEXIT_CRITICAL();
+}
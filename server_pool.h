@@ -0,0 +1,63 @@
+#ifndef SERVER_POOL_H
+#define SERVER_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lwip/ip_addr.h"
+
+// Servidores de ingestão conhecidos (SERVER_IP + reservas)
+#define SERVER_POOL_MAX             4
+// RTT inicial antes da primeira resposta (todos empatam até serem medidos)
+#define SERVER_POOL_RTT_INIT_MS     200
+// Requisição sem resposta há mais de max(4 x RTT médio, STALL_MIN) marca o
+// servidor como travado: os próximos envios vão para outro antes do timeout
+#define SERVER_POOL_STALL_MIN_MS    500
+// Falhas seguidas que tiram o servidor da rotação; depois dele fora, uma
+// requisição de teste a cada PROBE_MS
+#define SERVER_POOL_DOWN_FAILS      2
+#define SERVER_POOL_PROBE_MS        15000
+// A cada N envios, um vai para o servidor saudável menos usado, para que o
+// RTT dos reservas continue medido
+#define SERVER_POOL_EXPLORE_EVERY   20
+
+typedef struct {
+	ip_addr_t addr;
+	uint16_t port;
+	bool down;                  // Fora da rotação (SERVER_POOL_DOWN_FAILS)
+	uint32_t rtt_ewma_ms;       // Média móvel da latência (alfa = 1/4)
+	uint32_t fail_permille;     // Média móvel da taxa de falhas (alfa = 1/8)
+	uint32_t consecutive_fails;
+	uint32_t in_flight;
+	uint32_t pending_since_ms;  // Última resposta ou envio com fila vazia
+	uint32_t down_since_ms;     // Último teste enquanto fora
+	uint32_t last_pick_ms;
+	// Contadores
+	uint32_t requests;
+	uint32_t failures;
+} server_endpoint_t;
+
+typedef struct {
+	uint32_t count;
+	uint32_t failovers;         // Trocas de servidor por falha/travamento
+	uint32_t explores;
+	uint32_t probes;
+	int32_t current;            // Último servidor escolhido (-1 = nenhum)
+} server_pool_stats_t;
+
+void server_pool_init(void);
+// false se a lista estiver cheia ou o IP for inválido
+bool server_pool_add(const char *ip, uint16_t port);
+
+// Escolhe o servidor para o próximo envio e o conta como em curso; -1 se a
+// lista estiver vazia
+int server_pool_pick(uint32_t now_ms);
+// Envio não chegou ao TCP: desfaz a contagem de server_pool_pick()
+void server_pool_cancel(int index);
+// Resultado de uma requisição (chamado no contexto do lwIP)
+void server_pool_result(const ip_addr_t *addr, uint16_t port, bool ok,
+                        uint32_t latency_ms, uint32_t now_ms);
+
+void server_pool_get(int index, server_endpoint_t *out);
+void server_pool_get_stats(server_pool_stats_t *out);
+
+#endif // SERVER_POOL_H
@@ -1 +1,410 @@
-// ...código copiado de ssd1306.c do template...
+/**
+ * Driver do display OLED SSD1306 (128x64, I2C)
+ *
+ * O desenho acontece só no framebuffer em RAM; cada operação marca a faixa
+ * de colunas alterada na página (8 linhas) correspondente. O ssd1306_show()
+ * compara essas faixas com a cópia do que já está no painel, corta as pontas
+ * iguais e envia só o restante em janelas SET_COL_ADDR/SET_PAGE_ADDR
+ * (endereçamento horizontal: a janela é percorrida página a página). Páginas
+ * vizinhas viram uma janela só quando isso custa menos bytes no barramento
+ * que duas janelas separadas. O I2C0 é dividido com o TCS34725, então cada
+ * byte a menos é tempo de barramento devolvido ao sensor.
+ */
+
+#include <string.h>
+
+#include "ssd1306.h"
+#include "font.h"
+#include "font_scaled.h"
+
+// Uma transferência de dados: controle + até a tela inteira
+static uint8_t tx[1 + SSD1306_BUF_LEN];
+
+static void bus_write(ssd1306_t *disp, const uint8_t *buf, size_t len) {
+    i2c_write_blocking(disp->i2c_port, disp->address, buf, len, false);
+    // + 1: byte de endereço do escravo
+    disp->stats.bus_bytes += len + 1;
+}
+
+static void send_commands(ssd1306_t *disp, const uint8_t *cmds, size_t len) {
+    tx[0] = SSD1306_CTRL_CMD;
+    memcpy(&tx[1], cmds, len);
+    bus_write(disp, tx, len + 1);
+}
+
+static void mark_clean(ssd1306_t *disp) {
+    memset(disp->dirty_x0, 0xFF, sizeof(disp->dirty_x0));
+    memset(disp->dirty_x1, 0x00, sizeof(disp->dirty_x1));
+}
+
+static inline void mark_dirty(ssd1306_t *disp, uint8_t page, uint8_t x0, uint8_t x1) {
+    if (x0 < disp->dirty_x0[page]) {
+        disp->dirty_x0[page] = x0;
+    }
+    if (x1 > disp->dirty_x1[page]) {
+        disp->dirty_x1[page] = x1;
+    }
+}
+
+void ssd1306_init(ssd1306_t *disp, i2c_inst_t *i2c_port, uint8_t address) {
+    disp->i2c_port = i2c_port;
+    disp->address = address;
+    disp->width = SSD1306_WIDTH;
+    disp->height = SSD1306_HEIGHT;
+    disp->stats = (ssd1306_stats_t){ 0 };
+    memset(disp->buffer, 0, sizeof(disp->buffer));
+    mark_clean(disp);
+
+    static const uint8_t init_cmds[] = {
+        SSD1306_SET_DISP | 0x00,            // Desliga durante a configuração
+        SSD1306_SET_DISP_CLK_DIV, 0x80,
+        SSD1306_SET_MUX_RATIO, SSD1306_HEIGHT - 1,
+        SSD1306_SET_DISP_OFFSET, 0x00,
+        SSD1306_SET_DISP_START_LINE | 0x00,
+        SSD1306_SET_CHARGE_PUMP, 0x14,      // Regulador interno
+        SSD1306_SET_MEM_ADDR, 0x00,         // Horizontal: janelas COL/PAGE
+        SSD1306_SET_SEG_REMAP | 0x01,       // Coluna 127 no SEG0
+        SSD1306_SET_COM_OUT_DIR | 0x08,     // Varre de COM[N-1] a COM0
+        SSD1306_SET_COM_PIN_CFG, 0x12,
+        SSD1306_SET_CONTRAST, 0xCF,
+        SSD1306_SET_PRECHARGE, 0xF1,
+        SSD1306_SET_VCOM_DESEL, 0x40,
+        SSD1306_SET_ENTIRE_ON,              // Segue a RAM
+        SSD1306_SET_NORM_INV,               // Não invertido
+        SSD1306_SET_DISP | 0x01,
+    };
+    send_commands(disp, init_cmds, sizeof(init_cmds));
+
+    // RAM do painel indefinida após o reset: o primeiro show() manda tudo
+    disp->shown_valid = false;
+}
+
+void ssd1306_canvas_init(ssd1306_t *canvas) {
+    memset(canvas, 0, sizeof(*canvas));
+    canvas->width = SSD1306_WIDTH;
+    canvas->height = SSD1306_HEIGHT;
+    mark_clean(canvas);
+}
+
+void ssd1306_copy_dirty(ssd1306_t *dst, ssd1306_t *src) {
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        uint8_t x0 = src->dirty_x0[page];
+        uint8_t x1 = src->dirty_x1[page];
+        if (x0 > x1) {
+            continue;
+        }
+        size_t offset = (size_t)page * SSD1306_WIDTH + x0;
+        memcpy(&dst->buffer[offset], &src->buffer[offset], (size_t)(x1 - x0 + 1));
+        mark_dirty(dst, page, x0, x1);
+    }
+    mark_clean(src);
+}
+
+void ssd1306_invalidate(ssd1306_t *disp) {
+    disp->shown_valid = false;
+}
+
+void ssd1306_clear(ssd1306_t *disp) {
+    memset(disp->buffer, 0, sizeof(disp->buffer));
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        mark_dirty(disp, page, 0, SSD1306_WIDTH - 1);
+    }
+}
+
+// Envia uma janela de páginas [p0, p1] x colunas [x0, x1] e atualiza a cópia
+static void send_window(ssd1306_t *disp, uint8_t p0, uint8_t p1, uint8_t x0, uint8_t x1) {
+    const uint8_t window[] = {
+        SSD1306_SET_COL_ADDR, x0, x1,
+        SSD1306_SET_PAGE_ADDR, p0, p1,
+    };
+    send_commands(disp, window, sizeof(window));
+
+    size_t width = (size_t)(x1 - x0 + 1);
+    size_t len = 1;
+    tx[0] = SSD1306_CTRL_DATA;
+    for (uint8_t page = p0; page <= p1; page++) {
+        size_t offset = (size_t)page * SSD1306_WIDTH + x0;
+        memcpy(&tx[len], &disp->buffer[offset], width);
+        memcpy(&disp->shown[offset], &disp->buffer[offset], width);
+        len += width;
+    }
+    bus_write(disp, tx, len);
+    disp->stats.windows++;
+}
+
+uint32_t ssd1306_show(ssd1306_t *disp) {
+    uint64_t before = disp->stats.bus_bytes;
+    disp->stats.shows++;
+
+    if (!disp->shown_valid) {
+        send_window(disp, 0, SSD1306_PAGES - 1, 0, SSD1306_WIDTH - 1);
+        disp->shown_valid = true;
+        disp->stats.full_frames++;
+        mark_clean(disp);
+        disp->stats.last_bytes = (uint32_t)(disp->stats.bus_bytes - before);
+        return disp->stats.last_bytes;
+    }
+
+    // Janela em montagem: páginas [p0, p1], colunas [wx0, wx1]
+    int p0 = -1, p1 = -1;
+    uint8_t wx0 = 0, wx1 = 0;
+
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        int x0 = disp->dirty_x0[page];
+        int x1 = disp->dirty_x1[page];
+
+        // Corta as pontas que já estão iguais no painel
+        const uint8_t *row = &disp->buffer[page * SSD1306_WIDTH];
+        const uint8_t *shown = &disp->shown[page * SSD1306_WIDTH];
+        while (x0 <= x1 && row[x0] == shown[x0]) {
+            x0++;
+        }
+        while (x1 >= x0 && row[x1] == shown[x1]) {
+            x1--;
+        }
+        if (x0 > x1) {
+            continue;
+        }
+
+        if (p0 >= 0 && page == p1 + 1) {
+            // Junta à janela anterior se custar menos que uma janela nova
+            uint32_t ux0 = x0 < wx0 ? x0 : wx0;
+            uint32_t ux1 = x1 > wx1 ? x1 : wx1;
+            uint32_t pages = (uint32_t)(p1 - p0 + 1);
+            uint32_t merged = (pages + 1) * (ux1 - ux0 + 1);
+            uint32_t separate = pages * (uint32_t)(wx1 - wx0 + 1) + (uint32_t)(x1 - x0 + 1) +
+                                SSD1306_WINDOW_OVERHEAD;
+            if (merged <= separate) {
+                p1 = page;
+                wx0 = (uint8_t)ux0;
+                wx1 = (uint8_t)ux1;
+                continue;
+            }
+        }
+        if (p0 >= 0) {
+            send_window(disp, (uint8_t)p0, (uint8_t)p1, wx0, wx1);
+        }
+        p0 = p1 = page;
+        wx0 = (uint8_t)x0;
+        wx1 = (uint8_t)x1;
+    }
+    if (p0 >= 0) {
+        send_window(disp, (uint8_t)p0, (uint8_t)p1, wx0, wx1);
+    } else {
+        disp->stats.empty_shows++;
+    }
+    mark_clean(disp);
+
+    disp->stats.last_bytes = (uint32_t)(disp->stats.bus_bytes - before);
+    return disp->stats.last_bytes;
+}
+
+void ssd1306_draw_pixel(ssd1306_t *disp, int16_t x, int16_t y, bool on) {
+    if (x < 0 || y < 0 || x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+        return;
+    }
+    uint8_t page = (uint8_t)(y / 8);
+    uint8_t *byte = &disp->buffer[page * SSD1306_WIDTH + x];
+    uint8_t value = on ? (uint8_t)(*byte | (1u << (y % 8))) : (uint8_t)(*byte & ~(1u << (y % 8)));
+    if (value != *byte) {
+        *byte = value;
+        mark_dirty(disp, page, (uint8_t)x, (uint8_t)x);
+    }
+}
+
+// Célula opaca pixel a pixel: caminho de referência (e escalas acima de 3)
+static void draw_char_pixels(ssd1306_t *disp, int16_t x, int16_t y, uint8_t scale, char c) {
+    const uint8_t *glyph = font_5x7[(uint8_t)c - FONT_FIRST_CHAR];
+
+    for (int16_t col = 0; col < SSD1306_CHAR_WIDTH; col++) {
+        uint8_t bits = col < FONT_WIDTH ? glyph[col] : 0;
+        for (int16_t row = 0; row < SSD1306_CHAR_HEIGHT; row++) {
+            bool on = (bits >> row) & 1;
+            for (int16_t dx = 0; dx < scale; dx++) {
+                for (int16_t dy = 0; dy < scale; dy++) {
+                    ssd1306_draw_pixel(disp, (int16_t)(x + col * scale + dx),
+                                       (int16_t)(y + row * scale + dy), on);
+                }
+            }
+        }
+    }
+}
+
+// Coluna do glifo já esticada na vertical: 8 x scale linhas, bit 0 em cima
+static uint32_t glyph_strip(char c, uint8_t scale, int16_t col) {
+    if (col >= FONT_WIDTH) {
+        return 0;   // Espaço entre letras
+    }
+    uint8_t index = (uint8_t)c - FONT_FIRST_CHAR;
+    switch (scale) {
+    case 2:
+        return font_5x7_x2[index][col][0] | (uint32_t)font_5x7_x2[index][col][1] << 8;
+    case 3:
+        return font_5x7_x3[index][col][0] | (uint32_t)font_5x7_x3[index][col][1] << 8 |
+               (uint32_t)font_5x7_x3[index][col][2] << 16;
+    default:
+        return font_5x7[index][col];
+    }
+}
+
+// Byte de página com a faixa vertical strip (full = bits que ela ocupa)
+// mesclada; shift é a linha da faixa que cai no topo da página
+static inline uint8_t merge_strip(uint8_t byte, int16_t shift, uint32_t strip, uint32_t full) {
+    uint8_t bits, mask;
+    if (shift >= 0) {
+        bits = (uint8_t)(strip >> shift);
+        mask = (uint8_t)(full >> shift);
+    } else {
+        bits = (uint8_t)(strip << -shift);
+        mask = (uint8_t)(full << -shift);
+    }
+    return (uint8_t)((byte & ~mask) | bits);
+}
+
+// Célula opaca: apaga o fundo de 6x8 (x scale), então dá para reescrever um
+// campo sem limpar a tela. Até 3x cada coluna vai direto para os bytes das
+// páginas: com y múltiplo de 8 é uma cópia de bytes; fora disso a coluna é
+// deslocada e mesclada com máscara nas páginas que ela cruza
+void ssd1306_draw_char(ssd1306_t *disp, int16_t x, int16_t y, uint8_t scale, char c) {
+    if (scale == 0) {
+        scale = 1;
+    }
+    if ((uint8_t)c < FONT_FIRST_CHAR || (uint8_t)c > FONT_LAST_CHAR) {
+        c = '?';
+    }
+    int16_t w = (int16_t)(SSD1306_CHAR_WIDTH * scale);
+    int16_t h = (int16_t)(SSD1306_CHAR_HEIGHT * scale);
+    if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT || x + w <= 0 || y + h <= 0) {
+        return;
+    }
+    if (scale > SSD1306_BLIT_MAX_SCALE) {
+        draw_char_pixels(disp, x, y, scale, c);
+        return;
+    }
+
+    // Páginas cruzadas pela célula (até 4 com 3x desalinhado), já cortadas
+    int16_t first_page = (int16_t)((y >= 0 ? y : y - 7) / 8);
+    int16_t last_page = (int16_t)((y + h - 1) / 8);
+    int16_t p0 = first_page < 0 ? 0 : first_page;
+    int16_t p1 = last_page >= SSD1306_PAGES ? SSD1306_PAGES - 1 : last_page;
+    int16_t c0 = x < 0 ? (int16_t)-x : 0;
+    int16_t c1 = x + w > SSD1306_WIDTH ? (int16_t)(SSD1306_WIDTH - x) : w;
+    uint32_t full = (1u << h) - 1;
+    bool aligned = (y & 7) == 0;    // Cópia de bytes inteiros
+
+    // Faixa alterada por página, marcada uma vez no fim
+    int16_t changed_x0[4] = { SSD1306_WIDTH, SSD1306_WIDTH, SSD1306_WIDTH, SSD1306_WIDTH };
+    int16_t changed_x1[4] = { -1, -1, -1, -1 };
+
+    for (int16_t i = c0; i < c1; i++) {
+        uint32_t strip = glyph_strip(c, scale, i / scale);
+        int16_t px = (int16_t)(x + i);
+        for (int16_t page = p0; page <= p1; page++) {
+            uint8_t *byte = &disp->buffer[page * SSD1306_WIDTH + px];
+            uint8_t value = aligned ? (uint8_t)(strip >> (page * 8 - y))
+                                    : merge_strip(*byte, (int16_t)(page * 8 - y), strip, full);
+            if (value != *byte) {
+                *byte = value;
+                int16_t slot = (int16_t)(page - p0);
+                if (px < changed_x0[slot]) {
+                    changed_x0[slot] = px;
+                }
+                changed_x1[slot] = px;
+            }
+        }
+    }
+    for (int16_t page = p0; page <= p1; page++) {
+        int16_t slot = (int16_t)(page - p0);
+        if (changed_x1[slot] >= 0) {
+            mark_dirty(disp, (uint8_t)page, (uint8_t)changed_x0[slot], (uint8_t)changed_x1[slot]);
+        }
+    }
+}
+
+void ssd1306_draw_column(ssd1306_t *disp, int16_t x, int16_t y, uint8_t h, uint32_t bits) {
+    if (h == 0 || h > SSD1306_COLUMN_MAX_HEIGHT || x < 0 || x >= SSD1306_WIDTH ||
+        y >= SSD1306_HEIGHT || y + h <= 0) {
+        return;
+    }
+    int16_t first_page = (int16_t)((y >= 0 ? y : y - 7) / 8);
+    int16_t last_page = (int16_t)((y + h - 1) / 8);
+    int16_t p0 = first_page < 0 ? 0 : first_page;
+    int16_t p1 = last_page >= SSD1306_PAGES ? SSD1306_PAGES - 1 : last_page;
+    uint32_t full = (1u << h) - 1;
+    bits &= full;
+
+    for (int16_t page = p0; page <= p1; page++) {
+        uint8_t *byte = &disp->buffer[page * SSD1306_WIDTH + x];
+        uint8_t value = merge_strip(*byte, (int16_t)(page * 8 - y), bits, full);
+        if (value != *byte) {
+            *byte = value;
+            mark_dirty(disp, (uint8_t)page, (uint8_t)x, (uint8_t)x);
+        }
+    }
+}
+
+typedef void (*draw_char_fn)(ssd1306_t *, int16_t, int16_t, uint8_t, char);
+
+static void draw_text(ssd1306_t *disp, int16_t x, int16_t y, uint8_t scale, const char *str,
+                      draw_char_fn draw) {
+    if (scale == 0) {
+        scale = 1;
+    }
+    int16_t start_x = x;
+    for (; *str; str++) {
+        if (*str == '\n') {
+            x = start_x;
+            y = (int16_t)(y + SSD1306_CHAR_HEIGHT * scale);
+            continue;
+        }
+        if (x >= SSD1306_WIDTH) {
+            continue;   // Fora da tela: só procura o próximo '\n'
+        }
+        draw(disp, x, y, scale, *str);
+        x = (int16_t)(x + SSD1306_CHAR_WIDTH * scale);
+    }
+}
+
+void ssd1306_draw_string(ssd1306_t *disp, int16_t x, int16_t y, uint8_t scale, const char *str) {
+    draw_text(disp, x, y, scale, str, ssd1306_draw_char);
+}
+
+static void draw_char_reference(ssd1306_t *disp, int16_t x, int16_t y, uint8_t scale, char c) {
+    if ((uint8_t)c < FONT_FIRST_CHAR || (uint8_t)c > FONT_LAST_CHAR) {
+        c = '?';
+    }
+    draw_char_pixels(disp, x, y, scale, c);
+}
+
+void ssd1306_bench_text(ssd1306_t *disp, int16_t x, int16_t y, uint8_t scale, const char *str,
+                        uint32_t iterations, ssd1306_text_bench_t *out) {
+    static const draw_char_fn paths[2] = { ssd1306_draw_char, draw_char_reference };
+    uint64_t elapsed[2];
+
+    // Células opacas: a mesma string em espaços apaga o que foi desenhado,
+    // então toda passada grava bytes de verdade
+    char blank[64];
+    size_t len = 0;
+    for (; str[len] && len < sizeof(blank) - 1; len++) {
+        blank[len] = str[len] == '\n' ? '\n' : ' ';
+    }
+    blank[len] = '\0';
+
+    if (iterations == 0) {
+        iterations = 1;
+    }
+    for (int path = 0; path < 2; path++) {
+        ssd1306_clear(disp);
+        uint64_t t0 = time_us_64();
+        for (uint32_t i = 0; i < iterations; i++) {
+            draw_text(disp, x, y, scale, str, paths[path]);
+            draw_text(disp, x, y, scale, blank, paths[path]);
+        }
+        elapsed[path] = time_us_64() - t0;
+    }
+    ssd1306_clear(disp);
+
+    out->iterations = iterations;
+    out->blit_us = (float)elapsed[0] / (2.0f * iterations);
+    out->pixel_us = (float)elapsed[1] / (2.0f * iterations);
+}
@@ -7,6 +7,8 @@
 #define SSD1306_I2C_ADDR        0x3C
 #define SSD1306_HEIGHT          64
 #define SSD1306_WIDTH           128
+#define SSD1306_PAGES           (SSD1306_HEIGHT / 8)
+#define SSD1306_BUF_LEN         (SSD1306_WIDTH * SSD1306_PAGES)
 
 // Comandos
 #define SSD1306_SET_CONTRAST    0x81
@@ -27,19 +29,74 @@
 #define SSD1306_SET_VCOM_DESEL  0xDB
 #define SSD1306_SET_CHARGE_PUMP 0x8D
 
+// Byte de controle que abre cada transferência I2C
+#define SSD1306_CTRL_CMD        0x00
+#define SSD1306_CTRL_DATA       0x40
+
+// Custo fixo de uma janela no barramento: endereço + controle + 6 bytes de
+// SET_COL_ADDR/SET_PAGE_ADDR, e endereço + controle dos dados
+#define SSD1306_WINDOW_OVERHEAD 10
+
+// Fonte 5x7 em células de 6x8 pixels (uma coluna de espaço entre letras)
+#define SSD1306_CHAR_WIDTH      6
+#define SSD1306_CHAR_HEIGHT     8
+// Maior escala com tabela pronta (font_scaled.h); acima disso, pixel a pixel
+#define SSD1306_BLIT_MAX_SCALE  3
+// Maior faixa vertical de ssd1306_draw_column(): cabe deslocada em 32 bits
+#define SSD1306_COLUMN_MAX_HEIGHT 24
+
+typedef struct {
+	uint32_t shows;             // Chamadas de ssd1306_show()
+	uint32_t empty_shows;       // ... sem nada alterado no painel
+	uint32_t windows;           // Janelas COL/PAGE enviadas
+	uint32_t full_frames;       // Envios da tela inteira (primeiro/invalidado)
+	uint64_t bus_bytes;         // Bytes no I2C, com endereço e controle
+	uint32_t last_bytes;        // Bytes do último ssd1306_show()
+} ssd1306_stats_t;
+
+typedef struct {
+	uint32_t iterations;        // Strings desenhadas em cada caminho
+	float blit_us;              // Por string, blitter por página
+	float pixel_us;             // Por string, ssd1306_draw_pixel() por pixel
+} ssd1306_text_bench_t;
+
 typedef struct {
 	i2c_inst_t *i2c_port;
 	uint8_t address;
 	uint8_t width;
 	uint8_t height;
-	uint8_t buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
+	uint8_t buffer[SSD1306_BUF_LEN];
+	// Cópia do que está na RAM do painel: o show() manda só o que difere
+	uint8_t shown[SSD1306_BUF_LEN];
+	bool shown_valid;
+	// Colunas alteradas por página desde o último show (x0 > x1 = página limpa)
+	uint8_t dirty_x0[SSD1306_PAGES];
+	uint8_t dirty_x1[SSD1306_PAGES];
+	ssd1306_stats_t stats;
 } ssd1306_t;
 
 void ssd1306_init(ssd1306_t *display, i2c_inst_t *i2c_port, uint8_t address);
+// Framebuffer só para desenho, sem painel (canvas de trás do display.c)
+void ssd1306_canvas_init(ssd1306_t *canvas);
+// Copia para dst as regiões alteradas em src, somando-as às de dst, e limpa
+// as de src
+void ssd1306_copy_dirty(ssd1306_t *dst, ssd1306_t *src);
 void ssd1306_clear(ssd1306_t *display);
-void ssd1306_show(ssd1306_t *display);
+// Envia ao painel só as regiões alteradas; retorna os bytes gravados no I2C
+// (0 = nada mudou)
+uint32_t ssd1306_show(ssd1306_t *display);
+// Força o próximo show() a reenviar a tela inteira (painel resetado etc.)
+void ssd1306_invalidate(ssd1306_t *display);
 void ssd1306_draw_pixel(ssd1306_t *display, int16_t x, int16_t y, bool on);
-void ssd1306_draw_char(ssd1306_t *display, int16_t x, int16_t y, char c);
-void ssd1306_draw_string(ssd1306_t *display, int16_t x, int16_t y, const char *str);
+// Grava a coluna x, linhas [y, y + h), de uma vez: bit 0 de bits = linha y.
+// Opaca (bits em 0 apagam); h até SSD1306_COLUMN_MAX_HEIGHT
+void ssd1306_draw_column(ssd1306_t *display, int16_t x, int16_t y, uint8_t h, uint32_t bits);
+// scale multiplica a célula de 6x8 (1 = 21 colunas x 8 linhas de texto)
+void ssd1306_draw_char(ssd1306_t *display, int16_t x, int16_t y, uint8_t scale, char c);
+void ssd1306_draw_string(ssd1306_t *display, int16_t x, int16_t y, uint8_t scale, const char *str);
+// Mede str desenhada pelo blitter e pixel a pixel em (x, y); usa o
+// framebuffer como rascunho e o deixa limpo
+void ssd1306_bench_text(ssd1306_t *display, int16_t x, int16_t y, uint8_t scale, const char *str,
+                        uint32_t iterations, ssd1306_text_bench_t *out);
 
 #endif // SSD1306_H
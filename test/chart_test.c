@@ -0,0 +1,100 @@
+/**
+ * Teste de host do chart: depois de cada chart_push() a área do gráfico no
+ * painel precisa ser igual a um redesenho completo do mesmo estado, e um
+ * push sem mudança de escala só pode regravar três colunas
+ *
+ * Inclui o chart.c para redesenhar com o draw_col() (static) como referência.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "chart.c"
+#include "panel_emu.h"
+#include "test_check.h"
+
+#define CHART_SAMPLES           5000
+#define CHART_Y                 32
+#define CHART_HEIGHT            24
+#define CHART_STEP_MM           50
+
+static ssd1306_t panel;
+static ssd1306_t reference;
+static chart_t chart;
+
+// Páginas cobertas pelo gráfico (y alinhado em página no layout do firmware)
+#define CHART_PAGE0             (CHART_Y / 8)
+#define CHART_PAGES             (CHART_HEIGHT / 8)
+
+static void test_incremental_matches_redraw(void) {
+    panel_emu_reset();
+    ssd1306_init(&panel, i2c0, SSD1306_I2C_ADDR);
+    ssd1306_show(&panel);
+    chart_init(&chart, 0, CHART_Y, SSD1306_WIDTH, CHART_HEIGHT, CHART_STEP_MM);
+
+    int32_t value = 600;
+    uint64_t start = panel.stats.bus_bytes;
+    uint32_t max_incremental = 0;
+    uint32_t max_wrap = 0;
+    for (int i = 0; i < CHART_SAMPLES; i++) {
+        // Passeio aleatório com saltos e leituras inválidas
+        value += (int32_t)rng_range(41) - 20;
+        if (rng_range(300) == 0) {
+            value += (int32_t)rng_range(801) - 400;
+        }
+        value = value < 30 ? 30 : (value > 1990 ? 1990 : value);
+        uint16_t sample = rng_range(40) == 0 ? CHART_NO_VALUE : (uint16_t)value;
+
+        uint32_t columns = chart.stats.columns;
+        uint32_t redraws = chart.stats.redraws;
+        chart_push(&chart, &panel, sample);
+        bool redrawn = chart.stats.redraws != redraws;
+        CHECK(redrawn || chart.stats.columns - columns == 3, "push %d: %u colunas", i,
+              (unsigned)(chart.stats.columns - columns));
+
+        // Na volta do cursor as três colunas ficam nas duas pontas, e a faixa
+        // suja de cada página (uma só) cobre a largura inteira
+        uint8_t pushed = (uint8_t)((chart.head + chart.width - 1) % chart.width);
+        bool wraps = pushed + 2 >= chart.width;
+        uint32_t bytes = ssd1306_show(&panel);
+        if (!redrawn) {
+            uint32_t *max = wraps ? &max_wrap : &max_incremental;
+            if (bytes > *max) {
+                *max = bytes;
+            }
+        }
+        CHECK(panel_emu_matches(&panel), "push %d: painel difere do framebuffer", i);
+
+        // Referência: o mesmo estado desenhado inteiro num canvas limpo
+        chart_t copy = chart;
+        ssd1306_canvas_init(&reference);
+        for (uint8_t col = 0; col < copy.width; col++) {
+            draw_col(&copy, &reference, col);
+        }
+        size_t offset = (size_t)CHART_PAGE0 * SSD1306_WIDTH;
+        CHECK(memcmp(&reference.buffer[offset], &panel.buffer[offset],
+                     (size_t)CHART_PAGES * SSD1306_WIDTH) == 0,
+              "push %d: gráfico incremental difere do redesenho", i);
+        if (failures) {
+            return;
+        }
+    }
+    printf("Gráfico: %u amostras, %u redesenhos de escala, %u colunas\n",
+           (unsigned)chart.stats.pushes, (unsigned)chart.stats.redraws,
+           (unsigned)chart.stats.columns);
+    printf("  %.1f bytes no I2C por amostra; sem mudança de escala até %u "
+           "(%u na volta do cursor)\n",
+           (double)(panel.stats.bus_bytes - start) / CHART_SAMPLES, (unsigned)max_incremental,
+           (unsigned)max_wrap);
+    // No máximo uma janela por página do gráfico, de três colunas (ou da
+    // largura inteira na volta)
+    CHECK(max_incremental <= CHART_PAGES * (SSD1306_WINDOW_OVERHEAD + 3),
+          "push sem mudança de escala custou %u bytes", (unsigned)max_incremental);
+    CHECK(max_wrap <= CHART_PAGES * (SSD1306_WINDOW_OVERHEAD + SSD1306_WIDTH),
+          "push na volta do cursor custou %u bytes", (unsigned)max_wrap);
+}
+
+int main(void) {
+    test_incremental_matches_redraw();
+    return test_result();
+}
@@ -0,0 +1,128 @@
+/**
+ * Painel SSD1306 emulado para os testes de host
+ *
+ * Substitui o i2c_write_blocking(): comandos (controle 0x00) movem a janela
+ * de endereçamento e dados (controle 0x40) são gravados na GDDRAM na ordem
+ * do modo horizontal. Os testes comparam essa RAM com o framebuffer do
+ * driver e contam os bytes que realmente passaram no barramento.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "panel_emu.h"
+
+i2c_inst_t *i2c0;
+panel_emu_t panel_emu;
+
+static uint8_t col_start, col_end, page_start, page_end;
+static uint8_t col, page;
+
+void panel_emu_reset(void) {
+    // RAM indefinida após o reset do controlador
+    memset(&panel_emu, 0, sizeof(panel_emu));
+    memset(panel_emu.ram, 0xA5, sizeof(panel_emu.ram));
+    col_start = col = 0;
+    col_end = SSD1306_WIDTH - 1;
+    page_start = page = 0;
+    page_end = SSD1306_PAGES - 1;
+}
+
+bool panel_emu_matches(const ssd1306_t *disp) {
+    return memcmp(panel_emu.ram, disp->buffer, sizeof(panel_emu.ram)) == 0;
+}
+
+// Bytes de argumento de cada comando usado pelo driver
+static int command_args(uint8_t cmd) {
+    switch (cmd) {
+    case SSD1306_SET_COL_ADDR:
+    case SSD1306_SET_PAGE_ADDR:
+        return 2;
+    case SSD1306_SET_CONTRAST:
+    case SSD1306_SET_MEM_ADDR:
+    case SSD1306_SET_MUX_RATIO:
+    case SSD1306_SET_DISP_OFFSET:
+    case SSD1306_SET_COM_PIN_CFG:
+    case SSD1306_SET_DISP_CLK_DIV:
+    case SSD1306_SET_PRECHARGE:
+    case SSD1306_SET_VCOM_DESEL:
+    case SSD1306_SET_CHARGE_PUMP:
+        return 1;
+    default:
+        if ((cmd & 0xFE) == SSD1306_SET_DISP || (cmd & 0xFE) == SSD1306_SET_SEG_REMAP ||
+            (cmd & 0xF7) == SSD1306_SET_COM_OUT_DIR || (cmd & 0xFE) == SSD1306_SET_ENTIRE_ON ||
+            (cmd & 0xFE) == SSD1306_SET_NORM_INV || (cmd & 0xC0) == SSD1306_SET_DISP_START_LINE) {
+            return 0;
+        }
+        return -1;
+    }
+}
+
+static void run_commands(const uint8_t *cmds, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        int args = command_args(cmds[i]);
+        if (args < 0 || i + (size_t)args >= len) {
+            printf("panel_emu: comando 0x%02X inválido ou truncado\n", cmds[i]);
+            panel_emu.errors++;
+            return;
+        }
+        if (cmds[i] == SSD1306_SET_COL_ADDR) {
+            col_start = col = cmds[i + 1];
+            col_end = cmds[i + 2];
+        } else if (cmds[i] == SSD1306_SET_PAGE_ADDR) {
+            page_start = page = cmds[i + 1];
+            page_end = cmds[i + 2];
+        } else if (cmds[i] == SSD1306_SET_MEM_ADDR && cmds[i + 1] != 0x00) {
+            printf("panel_emu: só o modo horizontal é emulado\n");
+            panel_emu.errors++;
+        }
+        i += (size_t)args;
+    }
+    if (col_end >= SSD1306_WIDTH || page_end >= SSD1306_PAGES || col_start > col_end ||
+        page_start > page_end) {
+        printf("panel_emu: janela inválida %u..%u x %u..%u\n", col_start, col_end, page_start,
+               page_end);
+        panel_emu.errors++;
+    }
+}
+
+static void write_data(const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        panel_emu.ram[page * SSD1306_WIDTH + col] = data[i];
+        if (++col > col_end) {
+            col = col_start;
+            if (++page > page_end) {
+                page = page_start;
+            }
+        }
+    }
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)i2c;
+    (void)nostop;
+    panel_emu.transfers++;
+    panel_emu.bus_bytes += len + 1;
+    if (addr != SSD1306_I2C_ADDR || len < 1) {
+        panel_emu.errors++;
+        return -1;
+    }
+    if (src[0] == SSD1306_CTRL_CMD) {
+        run_commands(&src[1], len - 1);
+    } else if (src[0] == SSD1306_CTRL_DATA) {
+        write_data(&src[1], len - 1);
+    } else {
+        printf("panel_emu: byte de controle 0x%02X\n", src[0]);
+        panel_emu.errors++;
+    }
+    return (int)len;
+}
+
+uint64_t time_us_64(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000u + (uint64_t)t.tv_nsec / 1000u;
+}
@@ -0,0 +1,24 @@
+#ifndef PANEL_EMU_H
+#define PANEL_EMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ssd1306.h"
+
+// SSD1306 emulado no lugar do I2C: interpreta SET_COL_ADDR/SET_PAGE_ADDR e
+// grava os bytes de dados na GDDRAM como o controlador em modo horizontal
+typedef struct {
+	uint8_t ram[SSD1306_BUF_LEN];
+	uint64_t bus_bytes;         // Com o byte de endereço, como o driver conta
+	uint32_t transfers;
+	uint32_t errors;            // Byte de controle ou comando desconhecido
+} panel_emu_t;
+
+extern panel_emu_t panel_emu;
+
+void panel_emu_reset(void);
+// RAM do painel igual ao framebuffer?
+bool panel_emu_matches(const ssd1306_t *disp);
+
+#endif // PANEL_EMU_H
@@ -0,0 +1,267 @@
+/**
+ * Teste de host do sample_codec: round-trip, lote de referência do server.py,
+ * prefixos truncados e mutações aleatórias no sample_codec_decode()
+ *
+ * Compilado com -fsanitize=address,undefined pelo test/CMakeLists.txt, então
+ * uma leitura fora do buffer em um lote corrompido derruba o teste.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sample_codec.h"
+#include "test_check.h"
+
+#define BATCH_MAX_SAMPLES       16
+#define BATCH_MAX_LEN           (SAMPLE_CODEC_MAX_HEADER_LEN + \
+                                 BATCH_MAX_SAMPLES * SAMPLE_CODEC_MAX_SAMPLE_LEN)
+#define SYNTHETIC_SAMPLES       2000
+#define BATCH_SIZE              8
+#define FUZZ_ITERATIONS         200000
+
+// ==================== Gerador ====================
+static uint16_t clamp_u16(int32_t value) {
+    return (uint16_t)(value < 0 ? 0 : (value > UINT16_MAX ? UINT16_MAX : value));
+}
+
+// Mesmo perfil do synthetic_samples() do server.py: canais estáveis com
+// ruído, troca de objeto em ~5% das leituras, período ~1,5 s
+static void synthetic_samples(SensorData *out, size_t count) {
+    uint64_t ts = 1760000000000ull;
+    int32_t base[5] = { 800, 900, 700, 2600, 120 };
+    uint8_t color_id = SAMPLE_COLOR_BRANCO;
+
+    for (size_t i = 0; i < count; i++) {
+        if (rng_range(100) < 5) {
+            for (int ch = 0; ch < 4; ch++) {
+                base[ch] = (int32_t)rng_range(0x10000);
+            }
+            base[4] = 20 + (int32_t)rng_range(1980);
+            color_id = (uint8_t)rng_range(SAMPLE_COLOR_COUNT);
+        }
+        ts += 1480 + rng_range(41);
+        out[i].timestamp_ms = ts;
+        out[i].red = clamp_u16(base[0] + (int32_t)rng_range(17) - 8);
+        out[i].green = clamp_u16(base[1] + (int32_t)rng_range(17) - 8);
+        out[i].blue = clamp_u16(base[2] + (int32_t)rng_range(17) - 8);
+        out[i].clear = clamp_u16(base[3] + (int32_t)rng_range(17) - 8);
+        out[i].distance = clamp_u16(base[4] + (int32_t)rng_range(17) - 8);
+        out[i].color_id = color_id;
+    }
+}
+
+// ==================== Codificação em buffer ====================
+typedef struct {
+    uint8_t buf[BATCH_MAX_LEN];
+    size_t len;
+} batch_buf_t;
+
+static void put_byte(void *ctx, uint8_t byte) {
+    batch_buf_t *b = ctx;
+    if (b->len < sizeof(b->buf)) {
+        b->buf[b->len] = byte;
+    }
+    b->len++;
+}
+
+static void encode(batch_buf_t *out, const SensorData *samples, uint32_t count, uint32_t seq) {
+    sample_batch_header_t header;
+    memset(&header, 0, sizeof(header));
+    for (int i = 0; i < SAMPLE_CODEC_DEVICE_ID_LEN; i++) {
+        header.device_id[i] = (uint8_t)(i + 1);
+    }
+    header.stream_id = 0x1234ABCDu;
+    header.seq = seq;
+    header.base_seq = seq;
+    header.count = count;
+    out->len = 0;
+    size_t len = sample_codec_encode(&header, samples, put_byte, out);
+    CHECK(len == out->len, "encode retornou %zu, escreveu %zu", len, out->len);
+    CHECK(out->len <= BATCH_MAX_LEN, "lote de %zu bytes passa de BATCH_MAX_LEN", out->len);
+}
+
+static bool same_sample(const SensorData *a, const SensorData *b) {
+    return a->timestamp_ms == b->timestamp_ms && a->red == b->red && a->green == b->green &&
+           a->blue == b->blue && a->clear == b->clear && a->distance == b->distance &&
+           a->color_id == b->color_id;
+}
+
+// ==================== Casos ====================
+// Gerado com server.encode_batch() (3 amostras, stream 0x1234ABCD, seq 300,
+// base_seq 298, ID 01..08): os dois lados precisam produzir os mesmos bytes
+static const uint8_t reference_batch[] = {
+    0x02, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xcd, 0xab, 0x34, 0x12, 0xac, 0x02,
+    0xaa, 0x02, 0x03, 0x80, 0x80, 0xb3, 0xc1, 0x9c, 0x33, 0x00, 0xd8, 0x0c, 0x92, 0x0e, 0xf4,
+    0x0a, 0xe6, 0x28, 0xf6, 0x01, 0x02, 0xda, 0x0b, 0x06, 0x07, 0x00, 0x0d, 0x03, 0x02, 0xdf,
+    0x0b, 0xa2, 0xe4, 0x04, 0xf1, 0x0d, 0x8a, 0xf5, 0x07, 0xd7, 0x28, 0xac, 0x1d, 0x0b,
+};
+
+static const SensorData reference_samples[] = {
+    { 812, 905, 698, 2611, 123, SAMPLE_COLOR_BRANCO, 1760000000000ull },
+    { 815, 901, 698, 2604, 121, SAMPLE_COLOR_BRANCO, 1760000001498ull },
+    { 40000, 12, 65535, 0, 1999, SAMPLE_COLOR_MARROM, 1760000003001ull },
+};
+
+static void test_reference(void) {
+    sample_batch_header_t header;
+    SensorData decoded[BATCH_MAX_SAMPLES];
+
+    int n = sample_codec_decode(reference_batch, sizeof(reference_batch), &header, decoded,
+                                BATCH_MAX_SAMPLES);
+    CHECK(n == 3, "lote de referência: %d amostras", n);
+    CHECK(header.stream_id == 0x1234ABCDu && header.seq == 300 && header.base_seq == 298,
+          "cabeçalho de referência: stream %08x seq %u base %u",
+          (unsigned)header.stream_id, (unsigned)header.seq, (unsigned)header.base_seq);
+    for (int i = 0; i < n && i < 3; i++) {
+        CHECK(same_sample(&decoded[i], &reference_samples[i]), "amostra de referência %d", i);
+    }
+
+    sample_batch_header_t in;
+    memset(&in, 0, sizeof(in));
+    for (int i = 0; i < SAMPLE_CODEC_DEVICE_ID_LEN; i++) {
+        in.device_id[i] = (uint8_t)(i + 1);
+    }
+    in.stream_id = 0x1234ABCDu;
+    in.seq = 300;
+    in.base_seq = 298;
+    in.count = 3;
+    batch_buf_t out = { .len = 0 };
+    sample_codec_encode(&in, reference_samples, put_byte, &out);
+    CHECK(out.len == sizeof(reference_batch) &&
+          memcmp(out.buf, reference_batch, sizeof(reference_batch)) == 0,
+          "encode difere do server.encode_batch() (%zu bytes)", out.len);
+}
+
+// Round-trip de todos os lotes e de todos os prefixos truncados; retorna os
+// bytes binários para o relatório de compressão
+static size_t test_round_trip(const SensorData *samples, size_t count, batch_buf_t *batches,
+                              size_t *batch_count) {
+    size_t total = 0;
+    sample_batch_header_t header;
+    SensorData decoded[BATCH_MAX_SAMPLES];
+
+    *batch_count = 0;
+    for (size_t i = 0; i < count; i += BATCH_SIZE) {
+        uint32_t n = (uint32_t)(count - i < BATCH_SIZE ? count - i : BATCH_SIZE);
+        batch_buf_t *b = &batches[(*batch_count)++];
+        encode(b, &samples[i], n, (uint32_t)(i / BATCH_SIZE));
+        total += b->len;
+
+        int got = sample_codec_decode(b->buf, b->len, &header, decoded, BATCH_MAX_SAMPLES);
+        CHECK(got == (int)n, "lote %zu: %d de %u amostras", i / BATCH_SIZE, got, (unsigned)n);
+        for (int k = 0; k < got; k++) {
+            CHECK(same_sample(&decoded[k], &samples[i + k]), "lote %zu amostra %d",
+                  i / BATCH_SIZE, k);
+        }
+
+        // Cópia exata do prefixo em um buffer do tamanho dele: o ASan pega
+        // qualquer leitura além do fim
+        for (size_t cut = 0; cut < b->len; cut++) {
+            uint8_t *prefix = malloc(cut ? cut : 1);
+            memcpy(prefix, b->buf, cut);
+            got = sample_codec_decode(prefix, cut, &header, decoded, BATCH_MAX_SAMPLES);
+            CHECK(got == -1, "lote %zu truncado em %zu bytes aceito (%d)", i / BATCH_SIZE, cut,
+                  got);
+            free(prefix);
+        }
+    }
+
+    // Mais amostras que o destino comporta: recusa sem escrever além dele
+    SensorData few[2];
+    int got = sample_codec_decode(batches[0].buf, batches[0].len, &header, few, 2);
+    CHECK(got == -1, "lote de %d amostras aceito em destino de 2", BATCH_SIZE);
+    return total;
+}
+
+static size_t mutate(uint8_t *out, const batch_buf_t *in) {
+    size_t len = in->len;
+    memcpy(out, in->buf, len);
+    uint32_t kind = rng_range(5);
+    if (kind == 0) {
+        return rng_range((uint32_t)len);
+    }
+    uint32_t edits = 1 + rng_range(4);
+    for (uint32_t e = 0; e < edits; e++) {
+        size_t pos = rng_range((uint32_t)len);
+        switch (kind) {
+        case 1:
+            out[pos] = (uint8_t)rng_next();
+            break;
+        case 2:
+            out[pos] ^= (uint8_t)(1u << rng_range(8));
+            break;
+        case 3:
+            if (len < BATCH_MAX_LEN + 4) {
+                memmove(&out[pos + 1], &out[pos], len - pos);
+                out[pos] = (uint8_t)rng_next();
+                len++;
+            }
+            break;
+        default:
+            if (len > 1) {
+                memmove(&out[pos], &out[pos + 1], len - pos - 1);
+                len--;
+            }
+            break;
+        }
+    }
+    return len;
+}
+
+static uint32_t test_fuzz(const batch_buf_t *batches, size_t batch_count) {
+    uint32_t rejected = 0;
+    sample_batch_header_t header;
+    SensorData decoded[BATCH_MAX_SAMPLES];
+    uint8_t work[BATCH_MAX_LEN + 4];
+
+    for (uint32_t it = 0; it < FUZZ_ITERATIONS; it++) {
+        size_t len = mutate(work, &batches[rng_range((uint32_t)batch_count)]);
+        uint8_t *data = malloc(len ? len : 1);
+        memcpy(data, work, len);
+        int got = sample_codec_decode(data, len, &header, decoded, BATCH_MAX_SAMPLES);
+        free(data);
+        if (got < 0) {
+            rejected++;
+            continue;
+        }
+        CHECK(got <= BATCH_MAX_SAMPLES && (uint32_t)got == header.count,
+              "mutação %u aceita com %d amostras (count %u)", it, got, (unsigned)header.count);
+        for (int k = 0; k < got && k < BATCH_MAX_SAMPLES; k++) {
+            CHECK(decoded[k].color_id < SAMPLE_COLOR_COUNT, "mutação %u: cor %u", it,
+                  decoded[k].color_id);
+        }
+    }
+    return rejected;
+}
+
+int main(void) {
+    static SensorData samples[SYNTHETIC_SAMPLES];
+    static batch_buf_t batches[(SYNTHETIC_SAMPLES + BATCH_SIZE - 1) / BATCH_SIZE];
+    size_t batch_count;
+
+    test_reference();
+
+    synthetic_samples(samples, SYNTHETIC_SAMPLES);
+    size_t binary = test_round_trip(samples, SYNTHETIC_SAMPLES, batches, &batch_count);
+    uint32_t rejected = test_fuzz(batches, batch_count);
+
+    // Mesma URI que o GET /data antigo montava por amostra
+    size_t ascii = 0;
+    char uri[96];
+    for (size_t i = 0; i < SYNTHETIC_SAMPLES; i++) {
+        ascii += (size_t)snprintf(uri, sizeof(uri), "/data?r=%u&g=%u&b=%u&c=%u&dist=%u",
+                                  samples[i].red, samples[i].green, samples[i].blue,
+                                  samples[i].clear, samples[i].distance);
+    }
+
+    printf("Amostras: %d sintéticas em %zu lotes de %d\n", SYNTHETIC_SAMPLES, batch_count,
+           BATCH_SIZE);
+    printf("Fuzz: %d lotes corrompidos, %u recusados\n", FUZZ_ITERATIONS, (unsigned)rejected);
+    printf("ASCII (URI): %zu bytes (%.1f B/amostra)\n", ascii, (double)ascii / SYNTHETIC_SAMPLES);
+    printf("Binário:     %zu bytes (%.1f B/amostra)\n", binary,
+           (double)binary / SYNTHETIC_SAMPLES);
+    printf("Compressão:  %.2fx\n", (double)ascii / (double)binary);
+
+    return test_result();
+}
@@ -0,0 +1,98 @@
+/**
+ * Teste de host do blitter de texto do ssd1306: cada glifo desenhado por
+ * página precisa deixar o framebuffer e as faixas sujas idênticos ao
+ * desenho pixel a pixel, em qualquer posição, escala e recorte
+ *
+ * Inclui o ssd1306.c para chegar ao draw_char_pixels() (static), a
+ * referência; por isso este executável não linka o ssd1306.c de novo.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1306.c"
+#include "panel_emu.h"
+#include "test_check.h"
+
+#define BLIT_CASES              200000
+#define BENCH_ITERATIONS        2000
+
+static ssd1306_t blit;
+static ssd1306_t pixel;
+static uint8_t initial[SSD1306_BUF_LEN];
+
+static void test_blit_matches_pixels(void) {
+    for (int i = 0; i < BLIT_CASES; i++) {
+        // Fundo aleatório: o blitter precisa preservar os bits fora do glifo
+        for (size_t k = 0; k < sizeof(initial); k++) {
+            initial[k] = (uint8_t)rng_next();
+        }
+        int16_t x = (int16_t)((int)rng_range(170) - 30);
+        int16_t y = (int16_t)((int)rng_range(110) - 40);
+        uint8_t scale = (uint8_t)(1 + rng_range(SSD1306_BLIT_MAX_SCALE + 1));
+        char c = rng_range(50) == 0 ? (char)200 : (char)(32 + rng_range(96));
+
+        ssd1306_canvas_init(&blit);
+        ssd1306_canvas_init(&pixel);
+        memcpy(blit.buffer, initial, sizeof(initial));
+        memcpy(pixel.buffer, initial, sizeof(initial));
+        ssd1306_draw_char(&blit, x, y, scale, c);
+        // Fora da fonte o driver desenha '?'
+        draw_char_pixels(&pixel, x, y, scale,
+                         ((uint8_t)c < 32 || (uint8_t)c > 126) ? '?' : c);
+
+        CHECK(memcmp(blit.buffer, pixel.buffer, sizeof(initial)) == 0,
+              "caso %d: framebuffer difere (x=%d y=%d escala %u '%c')", i, x, y, scale, c);
+        for (int page = 0; page < SSD1306_PAGES; page++) {
+            bool pixel_dirty = pixel.dirty_x0[page] <= pixel.dirty_x1[page];
+            bool blit_dirty = blit.dirty_x0[page] <= blit.dirty_x1[page];
+            // Só bytes que mudaram sujam a página; a faixa precisa ser a mesma
+            CHECK(pixel_dirty == blit_dirty &&
+                  (!pixel_dirty || (blit.dirty_x0[page] == pixel.dirty_x0[page] &&
+                                    blit.dirty_x1[page] == pixel.dirty_x1[page])),
+                  "caso %d: faixa suja da página %d (x=%d y=%d escala %u)", i, page, x, y,
+                  scale);
+        }
+        if (failures) {
+            return;
+        }
+    }
+    printf("Blitter: %d glifos idênticos ao desenho pixel a pixel\n", BLIT_CASES);
+}
+
+// Os mesmos casos do main.c, no host (com sanitizers, os tempos só servem
+// para comparar os dois caminhos entre si)
+static void bench(void) {
+    static const struct {
+        const char *str;
+        uint8_t scale;
+        int16_t y;
+    } cases[] = {
+        { "Dist: 1234 mm", 2, 0 },
+        { "Dist: 1234 mm", 2, 3 },
+        { "Cor: VERMELHO", 1, 24 },
+        { "Cor: VERMELHO", 1, 27 },
+        { "123", 3, 16 },
+    };
+
+    printf("Texto (%d strings por caso):\n", BENCH_ITERATIONS);
+    ssd1306_canvas_init(&blit);
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        ssd1306_text_bench_t r;
+        ssd1306_bench_text(&blit, 0, cases[i].y, cases[i].scale, cases[i].str,
+                           BENCH_ITERATIONS, &r);
+        CHECK(r.iterations == BENCH_ITERATIONS, "bench: %u iterações", (unsigned)r.iterations);
+        printf("  %-14s %ux y=%-2d  blit %6.2f us  pixel %7.2f us  (%.1fx)\n", cases[i].str,
+               cases[i].scale, cases[i].y, r.blit_us, r.pixel_us,
+               r.blit_us > 0 ? r.pixel_us / r.blit_us : 0.0f);
+    }
+    // O bench usa o framebuffer como rascunho e precisa devolvê-lo limpo
+    static const uint8_t zero[SSD1306_BUF_LEN];
+    CHECK(memcmp(blit.buffer, zero, sizeof(zero)) == 0, "bench: framebuffer não ficou limpo");
+}
+
+int main(void) {
+    test_blit_matches_pixels();
+    bench();
+    return test_result();
+}
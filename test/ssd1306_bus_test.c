@@ -0,0 +1,190 @@
+/**
+ * Teste de host do ssd1306: bytes no I2C por atualização e RAM do painel
+ * igual ao framebuffer depois de cada ssd1306_show()
+ *
+ * O painel é o emulador de test/panel_emu.c, que interpreta as janelas
+ * COL/PAGE como o controlador. Os casos de bytes usam o layout do main.c
+ * original (distância em 2x na linha 0, cor em 1x na linha 24, clear a cada
+ * quadro), o mesmo dos números do README. O último caso repete a troca de
+ * canvas do display.c (ssd1306_copy_dirty()).
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "panel_emu.h"
+#include "test_check.h"
+
+#define RANDOM_SESSION_FRAMES   1000
+#define RANDOM_OPS              20000
+#define HANDOFF_FLUSHES         5000
+// Controle + 0x21/0x22 + tela inteira, mais os dois bytes de endereço
+#define FULL_FRAME_BYTES        (1 + 1 + 6 + 1 + 1 + SSD1306_BUF_LEN)
+
+static ssd1306_t disp;
+
+static void frame(int dist, const char *color) {
+    char line1[22];
+    char line2[22];
+    snprintf(line1, sizeof(line1), "Dist: %4d mm", dist);
+    snprintf(line2, sizeof(line2), "Cor: %s", color);
+    ssd1306_clear(&disp);
+    ssd1306_draw_string(&disp, 0, 0, 2, line1);
+    ssd1306_draw_string(&disp, 0, 24, 1, line2);
+}
+
+// show() e confere retorno, contadores e a RAM do painel
+static uint32_t show_checked(const char *what) {
+    uint64_t before = panel_emu.bus_bytes;
+    uint32_t bytes = ssd1306_show(&disp);
+    CHECK(bytes == panel_emu.bus_bytes - before, "%s: show() retornou %u, barramento %llu", what,
+          (unsigned)bytes, (unsigned long long)(panel_emu.bus_bytes - before));
+    CHECK(disp.stats.last_bytes == bytes, "%s: last_bytes %u", what,
+          (unsigned)disp.stats.last_bytes);
+    CHECK(panel_emu_matches(&disp), "%s: RAM do painel difere do framebuffer", what);
+    CHECK(panel_emu.errors == 0, "%s: %u erros no protocolo", what, (unsigned)panel_emu.errors);
+    return bytes;
+}
+
+static void expect_bytes(const char *what, uint32_t expected) {
+    uint32_t bytes = show_checked(what);
+    CHECK(bytes == expected, "%s: %u bytes, esperado %u", what, (unsigned)bytes,
+          (unsigned)expected);
+    printf("  %-28s %5u bytes\n", what, (unsigned)bytes);
+}
+
+static void test_typical_updates(void) {
+    panel_emu_reset();
+    ssd1306_init(&disp, i2c0, SSD1306_I2C_ADDR);
+    CHECK(disp.stats.bus_bytes == 27, "init: %llu bytes",
+          (unsigned long long)disp.stats.bus_bytes);
+    printf("Bytes no I2C por atualização:\n");
+    printf("  %-28s %5llu bytes\n", "init", (unsigned long long)disp.stats.bus_bytes);
+
+    frame(153, "VERMELHO");
+    expect_bytes("primeiro quadro", FULL_FRAME_BYTES);
+    frame(153, "VERMELHO");
+    expect_bytes("quadro sem mudança", 0);
+    frame(154, "VERMELHO");
+    expect_bytes("distância, 1 dígito", 30);
+    frame(167, "VERMELHO");
+    expect_bytes("distância, 2 dígitos", 54);
+    frame(982, "VERMELHO");
+    expect_bytes("distância, 3 dígitos", 78);
+    frame(982, "AZUL");
+    expect_bytes("nome da cor", 57);
+    frame(1043, "VERDE");
+    expect_bytes("distância e cor", 137);
+    ssd1306_invalidate(&disp);
+    expect_bytes("invalidado", FULL_FRAME_BYTES);
+
+    // Sessão típica: distância oscilando, cor trocando de vez em quando
+    static const char *const colors[] = { "VERMELHO", "VERDE", "AZUL", "BRANCO" };
+    uint64_t start = disp.stats.bus_bytes;
+    int dist = 500;
+    for (int i = 0; i < RANDOM_SESSION_FRAMES; i++) {
+        dist += (int)rng_range(21) - 10;
+        frame(dist, colors[(i / 50) % 4]);
+        show_checked("sessão");
+    }
+    double average = (double)(disp.stats.bus_bytes - start) / RANDOM_SESSION_FRAMES;
+    printf("  %-28s %7.1f bytes (tela inteira: %d)\n", "média da sessão", average,
+           FULL_FRAME_BYTES);
+    CHECK(average < FULL_FRAME_BYTES / 10, "sessão: média de %.1f bytes por quadro", average);
+}
+
+// Pixels, colunas e texto em posições aleatórias (inclusive fora da tela),
+// clears e invalidações; o painel precisa acompanhar a cada show()
+static void test_random_ops(void) {
+    panel_emu_reset();
+    ssd1306_init(&disp, i2c0, SSD1306_I2C_ADDR);
+    show_checked("aleatório, primeiro");
+
+    for (int i = 0; i < RANDOM_OPS; i++) {
+        uint32_t ops = rng_range(6);
+        for (uint32_t k = 0; k < ops; k++) {
+            int16_t x = (int16_t)((int)rng_range(150) - 10);
+            int16_t y = (int16_t)((int)rng_range(90) - 12);
+            switch (rng_range(4)) {
+            case 0:
+                ssd1306_draw_pixel(&disp, x, y, rng_next() & 1);
+                break;
+            case 1:
+                ssd1306_draw_column(&disp, x, y,
+                                    (uint8_t)(1 + rng_range(SSD1306_COLUMN_MAX_HEIGHT)),
+                                    rng_next());
+                break;
+            case 2: {
+                char text[4] = { (char)(32 + rng_range(95)), (char)(32 + rng_range(95)), 0, 0 };
+                ssd1306_draw_string(&disp, x, y, (uint8_t)(1 + rng_range(4)), text);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        if (rng_range(50) == 0) {
+            ssd1306_clear(&disp);
+        }
+        if (rng_range(500) == 0) {
+            ssd1306_invalidate(&disp);
+        }
+        show_checked("aleatório");
+        if (failures) {
+            printf("  parou na operação %d\n", i);
+            return;
+        }
+    }
+    printf("Aleatório: %d atualizações, %u janelas, %u envios da tela inteira\n", RANDOM_OPS,
+           (unsigned)disp.stats.windows, (unsigned)disp.stats.full_frames);
+}
+
+// Canvas de trás + framebuffer da frente, como o display.c: várias
+// publicações por envio, e o painel igual à última publicada depois de cada um
+static void test_canvas_handoff(void) {
+    static ssd1306_t back;
+    uint32_t published = 0;
+
+    panel_emu_reset();
+    ssd1306_init(&disp, i2c0, SSD1306_I2C_ADDR);
+    ssd1306_canvas_init(&back);
+    for (int flush = 0; flush < HANDOFF_FLUSHES; flush++) {
+        uint32_t burst = 1 + rng_range(4);
+        for (uint32_t k = 0; k < burst; k++) {
+            char line[24];
+            snprintf(line, sizeof(line), "%4u mm", (unsigned)rng_range(2000));
+            ssd1306_draw_string(&back, 0, 0, 2, line);
+            if (rng_range(10) == 0) {
+                snprintf(line, sizeof(line), "Cor: %-16s", rng_range(2) ? "AZUL" : "VERMELHO");
+                ssd1306_draw_string(&back, 0, 24, 1, line);
+            }
+            if (rng_range(50) == 0) {
+                for (int j = 0; j < 30; j++) {
+                    ssd1306_draw_pixel(&back, (int16_t)rng_range(SSD1306_WIDTH),
+                                       (int16_t)rng_range(SSD1306_HEIGHT), rng_next() & 1);
+                }
+            }
+            published++;
+        }
+        ssd1306_copy_dirty(&disp, &back);
+        show_checked("canvas");
+        CHECK(memcmp(panel_emu.ram, back.buffer, sizeof(panel_emu.ram)) == 0,
+              "canvas: envio %d difere da última publicação", flush);
+        for (int page = 0; page < SSD1306_PAGES; page++) {
+            CHECK(back.dirty_x0[page] > back.dirty_x1[page], "canvas: página %d ainda suja",
+                  page);
+        }
+        if (failures) {
+            return;
+        }
+    }
+    printf("Canvas: %u publicações em %d envios\n", (unsigned)published, HANDOFF_FLUSHES);
+}
+
+int main(void) {
+    test_typical_updates();
+    test_random_ops();
+    test_canvas_handoff();
+    return test_result();
+}
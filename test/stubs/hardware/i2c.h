@@ -0,0 +1,12 @@
+// Stub de host: o barramento é o painel emulado de test/panel_emu.c
+#ifndef HARDWARE_I2C_H
+#define HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+typedef struct i2c_inst i2c_inst_t;
+extern i2c_inst_t *i2c0;
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+#endif // HARDWARE_I2C_H
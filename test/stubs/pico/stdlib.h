@@ -0,0 +1,11 @@
+// Stub de host: só o que os módulos testados usam do pico-sdk
+#ifndef PICO_STDLIB_H
+#define PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+uint64_t time_us_64(void);
+
+#endif // PICO_STDLIB_H
@@ -0,0 +1,42 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Falhas acumuladas: o teste segue e reporta todas antes de sair com 1
+static int failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FALHA %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        failures++; \
+    } \
+} while (0)
+
+// xorshift32: determinístico, a mesma falha se repete a cada execução
+static uint32_t rng_state = 1;
+
+static inline uint32_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static inline uint32_t rng_range(uint32_t n) {
+    return rng_next() % n;
+}
+
+static inline int test_result(void) {
+    if (failures) {
+        printf("%d falhas\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
+
+#endif // TEST_CHECK_H
@@ -0,0 +1,138 @@
+/**
+ * Teste de host dos widgets retidos (ui.c) no layout do firmware
+ * (display_ui_init() em main_wifi_safe.c)
+ *
+ * Depois de cada atualização incremental o painel precisa ser igual a todos
+ * os widgets redesenhados num canvas limpo, e setters sem mudança não podem
+ * redesenhar nem mandar nada ao painel.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ui.h"
+#include "panel_emu.h"
+#include "test_check.h"
+
+#define UI_UPDATES              5000
+
+static const uint8_t icon_wifi_columns[] = { 0x02, 0x09, 0x05, 0x35, 0x05, 0x09, 0x02 };
+static const uint8_t icon_no_wifi_columns[] = { 0x41, 0x22, 0x14, 0x08, 0x14, 0x22, 0x41 };
+static const ui_icon_t icon_wifi = { icon_wifi_columns, sizeof(icon_wifi_columns) };
+static const ui_icon_t icon_no_wifi = { icon_no_wifi_columns, sizeof(icon_no_wifi_columns) };
+
+static ui_widget_t ui_distance;
+static ui_widget_t ui_light;
+static ui_widget_t ui_color;
+static ui_widget_t ui_wifi_icon;
+static ui_widget_t ui_wifi_label;
+static ui_widget_t *const widgets[] = {
+    &ui_distance, &ui_light, &ui_color, &ui_wifi_icon, &ui_wifi_label,
+};
+#define WIDGET_COUNT            (sizeof(widgets) / sizeof(widgets[0]))
+
+static ssd1306_t panel;
+static ssd1306_t reference;
+
+static const char *const colors[] = { "VERMELHO", "AZUL", "VERDE", "BRANCO" };
+
+static void set_values(int32_t distance, int32_t clear, int color, bool wifi) {
+    char line[UI_TEXT_MAX + 1];
+    ui_value_set(&ui_distance, distance, distance < 2000);
+    ui_bar_set(&ui_light, clear);
+    snprintf(line, sizeof(line), "Cor: %s", colors[color]);
+    ui_label_set(&ui_color, line);
+    ui_icon_set(&ui_wifi_icon, wifi ? &icon_wifi : &icon_no_wifi);
+    ui_label_set(&ui_wifi_label, wifi ? "WiFi OK" : "Sem WiFi");
+}
+
+// Desenha os marcados, envia e confere contra o redesenho completo
+static uint32_t update(const char *what, uint32_t *drawn) {
+    *drawn = ui_draw(&panel, widgets, WIDGET_COUNT);
+    uint32_t bytes = ssd1306_show(&panel);
+    CHECK(panel_emu_matches(&panel), "%s: painel difere do framebuffer", what);
+
+    ssd1306_canvas_init(&reference);
+    ui_invalidate(widgets, WIDGET_COUNT);
+    ui_draw(&reference, widgets, WIDGET_COUNT);
+    CHECK(memcmp(reference.buffer, panel.buffer, sizeof(panel.buffer)) == 0,
+          "%s: incremental difere do redesenho completo", what);
+    return bytes;
+}
+
+static void test_updates(void) {
+    uint32_t drawn;
+
+    panel_emu_reset();
+    ssd1306_init(&panel, i2c0, SSD1306_I2C_ADDR);
+    ui_value_init(&ui_distance, 0, 0, 2, 7, "%4ld mm", "---- mm");
+    ui_bar_init(&ui_light, 90, 17, 38, 6, UINT16_MAX);
+    ui_label_init(&ui_color, 0, 24, 1, 21, "Cor:");
+    ui_icon_init(&ui_wifi_icon, 0, 56, 8, &icon_no_wifi);
+    ui_label_init(&ui_wifi_label, 12, 56, 1, 19, "Sem WiFi");
+    set_values(1234, 20000, 0, false);
+    update("primeiro", &drawn);
+    CHECK(drawn == WIDGET_COUNT, "primeiro: %u widgets", (unsigned)drawn);
+
+    // Mesmos valores: nada redesenhado, nada no barramento
+    set_values(1234, 20000, 0, false);
+    uint32_t bytes = update("sem mudança", &drawn);
+    CHECK(drawn == 0 && bytes == 0, "sem mudança: %u widgets, %u bytes", (unsigned)drawn,
+          (unsigned)bytes);
+
+    // Clear diferente com o mesmo preenchimento da barra (36 colunas internas)
+    set_values(1234, 20001, 0, false);
+    bytes = update("barra igual", &drawn);
+    CHECK(drawn == 0 && bytes == 0, "barra igual: %u widgets, %u bytes", (unsigned)drawn,
+          (unsigned)bytes);
+
+    // Só o último dígito: dentro da célula 2x, o show() ainda corta as
+    // colunas iguais entre '4' e '5' (mesmo custo do layout antigo)
+    set_values(1235, 20001, 0, false);
+    bytes = update("distância, 1 dígito", &drawn);
+    CHECK(drawn == 1 && bytes == 30,
+          "distância, 1 dígito: %u widgets, %u bytes", (unsigned)drawn, (unsigned)bytes);
+    printf("Distância mudando 1 dígito: %u widget, %u bytes no I2C\n", (unsigned)drawn,
+           (unsigned)bytes);
+
+    int32_t distance = 500;
+    int32_t clear = 20000;
+    int color = 0;
+    bool wifi = false;
+    uint64_t start = panel.stats.bus_bytes;
+    uint32_t total_drawn = 0;
+    for (int i = 0; i < UI_UPDATES; i++) {
+        uint32_t what = rng_range(100);
+        distance += (int32_t)rng_range(21) - 10;
+        if (rng_range(200) == 0) {
+            distance = 2500;        // Leitura inválida
+        } else if (distance >= 2000) {
+            distance = 500;
+        }
+        clear += (int32_t)rng_range(201) - 100;
+        if (what < 3) {
+            color = (int)rng_range(4);
+        }
+        if (what == 50) {
+            wifi = !wifi;
+        }
+        if (what == 60) {
+            clear = (int32_t)rng_range(65536);
+        }
+        set_values(distance, clear, color, wifi);
+        update("aleatório", &drawn);
+        total_drawn += drawn;
+        if (failures) {
+            printf("  parou na atualização %d\n", i);
+            return;
+        }
+    }
+    printf("Aleatório: %d atualizações, %.2f widgets e %.1f bytes no I2C por atualização\n",
+           UI_UPDATES, (double)total_drawn / UI_UPDATES,
+           (double)(panel.stats.bus_bytes - start) / UI_UPDATES);
+}
+
+int main(void) {
+    test_updates();
+    return test_result();
+}
@@ -0,0 +1,176 @@
+/**
+ * Interface retida para o SSD1306: widgets com retângulo fixo
+ *
+ * Cada widget guarda o valor que está desenhado. Os setters comparam com o
+ * novo e só marcam o widget quando ele muda; o ui_draw() redesenha apenas os
+ * marcados, sempre por cima do retângulo inteiro (texto completado com
+ * espaços, barra e ícone opacos), então nada precisa ser apagado antes. Numa
+ * atualização em que só a distância mudou, o único retângulo tocado é o do
+ * número.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ui.h"
+
+static void text_init(ui_widget_t *w, ui_kind_t kind, int16_t x, int16_t y, uint8_t scale,
+                      uint8_t chars) {
+    memset(w, 0, sizeof(*w));
+    w->kind = kind;
+    w->x = x;
+    w->y = y;
+    w->scale = scale ? scale : 1;
+    w->chars = chars > UI_TEXT_MAX ? UI_TEXT_MAX : chars;
+    w->w = (uint8_t)(w->chars * SSD1306_CHAR_WIDTH * w->scale);
+    w->h = (uint8_t)(SSD1306_CHAR_HEIGHT * w->scale);
+    w->dirty = true;
+}
+
+void ui_label_init(ui_widget_t *w, int16_t x, int16_t y, uint8_t scale, uint8_t chars,
+                   const char *text) {
+    text_init(w, UI_LABEL, x, y, scale, chars);
+    snprintf(w->text, sizeof(w->text), "%s", text ? text : "");
+}
+
+void ui_value_init(ui_widget_t *w, int16_t x, int16_t y, uint8_t scale, uint8_t chars,
+                   const char *format, const char *invalid_text) {
+    text_init(w, UI_VALUE, x, y, scale, chars);
+    w->format = format;
+    w->invalid_text = invalid_text;
+}
+
+void ui_bar_init(ui_widget_t *w, int16_t x, int16_t y, uint8_t width, uint8_t height,
+                 int32_t max) {
+    memset(w, 0, sizeof(*w));
+    w->kind = UI_BAR;
+    w->x = x;
+    w->y = y;
+    w->w = width < 3 ? 3 : width;
+    w->h = height > SSD1306_COLUMN_MAX_HEIGHT ? SSD1306_COLUMN_MAX_HEIGHT
+                                              : (height < 3 ? 3 : height);
+    w->max = max > 0 ? max : 1;
+    w->dirty = true;
+}
+
+void ui_icon_init(ui_widget_t *w, int16_t x, int16_t y, uint8_t width, const ui_icon_t *icon) {
+    memset(w, 0, sizeof(*w));
+    w->kind = UI_ICON;
+    w->x = x;
+    w->y = y;
+    w->w = width;
+    w->h = 8;
+    w->icon = icon;
+    w->dirty = true;
+}
+
+void ui_label_set(ui_widget_t *w, const char *text) {
+    if (!text) {
+        text = "";
+    }
+    if (strncmp(w->text, text, UI_TEXT_MAX) == 0) {
+        return;
+    }
+    snprintf(w->text, sizeof(w->text), "%s", text);
+    w->dirty = true;
+}
+
+void ui_value_set(ui_widget_t *w, int32_t value, bool valid) {
+    if (valid == w->valid && (!valid || value == w->value)) {
+        return;
+    }
+    w->value = value;
+    w->valid = valid;
+    w->dirty = true;
+}
+
+void ui_bar_set(ui_widget_t *w, int32_t value) {
+    int32_t inner = w->w - 2;
+    if (value < 0) {
+        value = 0;
+    }
+    if (value > w->max) {
+        value = w->max;
+    }
+    uint8_t fill = (uint8_t)(value * inner / w->max);
+    if (fill == w->fill) {
+        return;
+    }
+    w->fill = fill;
+    w->dirty = true;
+}
+
+void ui_icon_set(ui_widget_t *w, const ui_icon_t *icon) {
+    if (icon == w->icon) {
+        return;
+    }
+    w->icon = icon;
+    w->dirty = true;
+}
+
+static void draw_text(ssd1306_t *canvas, const ui_widget_t *w, const char *text) {
+    char cells[UI_TEXT_MAX + 1];
+    snprintf(cells, sizeof(cells), "%-*.*s", w->chars, w->chars, text);
+    ssd1306_draw_string(canvas, w->x, w->y, w->scale, cells);
+}
+
+static void draw_bar(ssd1306_t *canvas, const ui_widget_t *w) {
+    uint32_t full = (1u << w->h) - 1u;
+    uint32_t frame = 1u | (1u << (w->h - 1));   // Só as bordas de cima e de baixo
+    for (uint8_t i = 0; i < w->w; i++) {
+        uint32_t bits;
+        if (i == 0 || i == w->w - 1) {
+            bits = full;
+        } else {
+            bits = (uint8_t)(i - 1) < w->fill ? full : frame;
+        }
+        ssd1306_draw_column(canvas, (int16_t)(w->x + i), w->y, w->h, bits);
+    }
+}
+
+static void draw_icon(ssd1306_t *canvas, const ui_widget_t *w) {
+    for (uint8_t i = 0; i < w->w; i++) {
+        uint8_t bits = w->icon && i < w->icon->width ? w->icon->columns[i] : 0;
+        ssd1306_draw_column(canvas, (int16_t)(w->x + i), w->y, w->h, bits);
+    }
+}
+
+uint32_t ui_draw(ssd1306_t *canvas, ui_widget_t *const *widgets, size_t count) {
+    uint32_t drawn = 0;
+    char text[UI_TEXT_MAX + 1];
+
+    for (size_t i = 0; i < count; i++) {
+        ui_widget_t *w = widgets[i];
+        if (!w->dirty) {
+            continue;
+        }
+        switch (w->kind) {
+        case UI_LABEL:
+            draw_text(canvas, w, w->text);
+            break;
+        case UI_VALUE:
+            if (w->valid) {
+                snprintf(text, sizeof(text), w->format, (long)w->value);
+            } else {
+                snprintf(text, sizeof(text), "%s", w->invalid_text ? w->invalid_text : "");
+            }
+            draw_text(canvas, w, text);
+            break;
+        case UI_BAR:
+            draw_bar(canvas, w);
+            break;
+        case UI_ICON:
+            draw_icon(canvas, w);
+            break;
+        }
+        w->dirty = false;
+        drawn++;
+    }
+    return drawn;
+}
+
+void ui_invalidate(ui_widget_t *const *widgets, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        widgets[i]->dirty = true;
+    }
+}
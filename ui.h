@@ -0,0 +1,65 @@
+#ifndef UI_H
+#define UI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ssd1306.h"
+
+// Texto de um widget: uma linha inteira da fonte 1x
+#define UI_TEXT_MAX             21
+
+typedef enum {
+	UI_LABEL,                   // Texto
+	UI_VALUE,                   // Número formatado (printf com um int32)
+	UI_BAR,                     // Barra horizontal de 0 a max
+	UI_ICON,                    // Bitmap de uma página (8 linhas)
+} ui_kind_t;
+
+typedef struct {
+	const uint8_t *columns;     // Um byte por coluna, bit 0 em cima
+	uint8_t width;
+} ui_icon_t;
+
+// Widget com retângulo fixo: os setters só marcam para redesenho quando o
+// valor ligado muda, e o ui_draw() só toca os widgets marcados
+typedef struct {
+	ui_kind_t kind;
+	int16_t x;
+	int16_t y;
+	uint8_t w;                  // Pixels
+	uint8_t h;
+	uint8_t scale;              // Texto (UI_LABEL/UI_VALUE)
+	uint8_t chars;              // Células do texto, completadas com espaço
+	bool dirty;
+	char text[UI_TEXT_MAX + 1];     // UI_LABEL
+	const char *format;         // UI_VALUE: ex. "%4ld mm"
+	const char *invalid_text;   // UI_VALUE: mostrado com valid = false
+	int32_t value;              // UI_VALUE
+	bool valid;                 // UI_VALUE
+	int32_t max;                // UI_BAR
+	uint8_t fill;               // UI_BAR: colunas preenchidas por dentro
+	const ui_icon_t *icon;      // UI_ICON
+} ui_widget_t;
+
+void ui_label_init(ui_widget_t *w, int16_t x, int16_t y, uint8_t scale, uint8_t chars,
+                   const char *text);
+void ui_value_init(ui_widget_t *w, int16_t x, int16_t y, uint8_t scale, uint8_t chars,
+                   const char *format, const char *invalid_text);
+// height até SSD1306_COLUMN_MAX_HEIGHT
+void ui_bar_init(ui_widget_t *w, int16_t x, int16_t y, uint8_t width, uint8_t height,
+                 int32_t max);
+void ui_icon_init(ui_widget_t *w, int16_t x, int16_t y, uint8_t width, const ui_icon_t *icon);
+
+void ui_label_set(ui_widget_t *w, const char *text);
+void ui_value_set(ui_widget_t *w, int32_t value, bool valid);
+// Só conta a mudança quando ela altera o preenchimento em pixels
+void ui_bar_set(ui_widget_t *w, int32_t value);
+void ui_icon_set(ui_widget_t *w, const ui_icon_t *icon);
+
+// Redesenha os widgets marcados no canvas; retorna quantos foram desenhados
+uint32_t ui_draw(ssd1306_t *canvas, ui_widget_t *const *widgets, size_t count);
+// Marca todos para redesenho (canvas apagado ou reiniciado)
+void ui_invalidate(ui_widget_t *const *widgets, size_t count);
+
+#endif // UI_H
@@ -0,0 +1,489 @@
+/**
+ * Uplink HTTP sem cópias intermediárias
+ *
+ * A requisição é serializada (formatação inteira, sem snprintf) direto em
+ * uma cadeia de pbufs customizados vindos de um pool dedicado, e enviada
+ * com tcp_write() sem TCP_WRITE_FLAG_COPY. Os buffers só voltam ao pool
+ * depois que o servidor confirma (ACK) todos os bytes.
+ */
+
+#include <string.h>
+#include "pico/cyw43_arch.h"
+#include "lwip/init.h"
+#include "lwip/memp.h"
+#include "lwip/sys.h"
+#include "lwip/tcp.h"
+
+#include "uplink.h"
+
+// Intervalo do tcp_poll em ticks do timer lento do TCP (500 ms)
+#define UPLINK_POLL_INTERVAL    1
+#define UPLINK_POLL_TIMEOUT     (UPLINK_TIMEOUT_MS / 500)
+
+typedef struct {
+    struct pbuf_custom pc;  // Deve ser o primeiro campo (pbuf -> buffer)
+    uint8_t data[UPLINK_BUF_SIZE];
+} uplink_buf_t;
+
+LWIP_MEMPOOL_DECLARE(UPLINK_POOL, UPLINK_POOL_SIZE, sizeof(uplink_buf_t), "Uplink req");
+
+typedef enum {
+    UPLINK_SLOT_FREE = 0,
+    UPLINK_SLOT_CONNECTING,     // SYN enviado, requisição ainda não escrita
+    UPLINK_SLOT_WAITING,        // Requisição escrita, aguardando resposta
+} uplink_slot_state_t;
+
+// Uma entrada por requisição em curso; o pcb aponta para a sua via tcp_arg()
+typedef struct {
+    uplink_slot_state_t state;
+    struct tcp_pcb *pcb;
+    struct pbuf *request;   // Cadeia do pool, mantida até o ACK completo
+    uint16_t acked;
+    uint16_t http_status;
+    uint8_t poll_ticks;
+    uint8_t timeout_ticks;
+    bool started;           // tcp_connect() aceito: entra na contabilidade
+    uint32_t start_ms;
+    ip_addr_t server;
+    uint16_t port;
+    uint32_t resp_pos;      // Bytes da resposta já vistos
+    uint8_t eoh_match;      // Progresso em "\r\n\r\n" (4 = corpo)
+    uint16_t body_len;
+    char body[UPLINK_RESP_BODY_MAX];
+    uplink_result_fn result_fn;
+    void *arg;
+} uplink_conn_t;
+
+static uplink_conn_t conns[UPLINK_MAX_INFLIGHT];
+static uplink_stats_t stats;
+
+// ==================== Pool de Buffers ====================
+static void uplink_buf_free(struct pbuf *p) {
+    LWIP_MEMPOOL_FREE(UPLINK_POOL, p);
+}
+
+static struct pbuf *uplink_buf_alloc(void) {
+    uplink_buf_t *buf = (uplink_buf_t *)LWIP_MEMPOOL_ALLOC(UPLINK_POOL);
+    if (!buf) {
+        stats.pool_exhausted++;
+        return NULL;
+    }
+    buf->pc.custom_free_function = uplink_buf_free;
+    return pbuf_alloced_custom(PBUF_RAW, UPLINK_BUF_SIZE, PBUF_REF, &buf->pc,
+                               buf->data, UPLINK_BUF_SIZE);
+}
+
+void uplink_init(void) {
+    LWIP_MEMPOOL_INIT(UPLINK_POOL);
+    memset(conns, 0, sizeof(conns));
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ==================== Serialização ====================
+static void uplink_put_char(uplink_writer_t *w, char c) {
+    if (w->overflow) {
+        return;
+    }
+    if (w->offset == UPLINK_BUF_SIZE) {
+        struct pbuf *next = uplink_buf_alloc();
+        if (!next) {
+            w->overflow = true;
+            return;
+        }
+        pbuf_cat(w->head, next);
+        w->cur = next;
+        w->offset = 0;
+    }
+    ((uint8_t *)w->cur->payload)[w->offset++] = (uint8_t)c;
+    w->length++;
+}
+
+bool uplink_begin_body(uplink_writer_t *w) {
+    memset(w, 0, sizeof(*w));
+    w->head = uplink_buf_alloc();
+    if (!w->head) {
+        return false;
+    }
+    w->cur = w->head;
+    return true;
+}
+
+bool uplink_begin_get(uplink_writer_t *w, const char *path) {
+    if (!uplink_begin_body(w)) {
+        return false;
+    }
+    uplink_put_str(w, "GET ");
+    uplink_put_str(w, path);
+    return true;
+}
+
+void uplink_put_byte(uplink_writer_t *w, uint8_t byte) {
+    uplink_put_char(w, (char)byte);
+}
+
+void uplink_put_str(uplink_writer_t *w, const char *str) {
+    while (*str) {
+        uplink_put_char(w, *str++);
+    }
+}
+
+void uplink_put_uint(uplink_writer_t *w, uint32_t value) {
+    uint32_t div = 1;
+    while (value / div >= 10) {
+        div *= 10;
+    }
+    do {
+        uplink_put_char(w, (char)('0' + (value / div) % 10));
+        div /= 10;
+    } while (div > 0);
+}
+
+// Divisões de 64 bits são emuladas no M0+: só para campos que exigem (timestamps)
+void uplink_put_uint64(uplink_writer_t *w, uint64_t value) {
+    uint64_t div = 1;
+    while (value / div >= 10) {
+        div *= 10;
+    }
+    do {
+        uplink_put_char(w, (char)('0' + (value / div) % 10));
+        div /= 10;
+    } while (div > 0);
+}
+
+void uplink_writer_discard(uplink_writer_t *w) {
+    if (w->head) {
+        pbuf_free(w->head);
+        w->head = NULL;
+    }
+}
+
+// ==================== Tabela de Requisições ====================
+static uplink_conn_t *uplink_slot_alloc(void) {
+    for (int i = 0; i < UPLINK_MAX_INFLIGHT; i++) {
+        if (conns[i].state == UPLINK_SLOT_FREE) {
+            return &conns[i];
+        }
+    }
+    return NULL;
+}
+
+static void uplink_release_request(uplink_conn_t *conn) {
+    if (conn->request) {
+        pbuf_free(conn->request);
+        conn->request = NULL;
+    }
+}
+
+// Encerra a conexão, contabiliza e notifica; retorna ERR_ABRT se o pcb foi abortado
+static err_t uplink_finish(uplink_conn_t *conn, uplink_result_t result) {
+    err_t ret = ERR_OK;
+    struct tcp_pcb *pcb = conn->pcb;
+
+    if (pcb) {
+        tcp_arg(pcb, NULL);
+        tcp_recv(pcb, NULL);
+        tcp_sent(pcb, NULL);
+        tcp_err(pcb, NULL);
+        tcp_poll(pcb, NULL, 0);
+        // Segmentos ainda não confirmados apontam para o pool: só o abort
+        // garante que o lwIP não os referencie depois da devolução
+        if (conn->request || tcp_close(pcb) != ERR_OK) {
+            tcp_abort(pcb);
+            ret = ERR_ABRT;
+        }
+        conn->pcb = NULL;
+    }
+    uplink_release_request(conn);
+
+    // Copia o contexto antes de liberar o slot: o callback pode iniciar
+    // uma nova requisição e reutilizá-lo
+    uplink_result_fn result_fn = conn->result_fn;
+    void *arg = conn->arg;
+    bool started = conn->started;
+    ip_addr_t server = conn->server;
+    uplink_response_t resp = {
+        .result = result,
+        .http_status = conn->http_status,
+        .latency_ms = to_ms_since_boot(get_absolute_time()) - conn->start_ms,
+        .body = conn->body,
+        .body_len = conn->body_len,
+        .server = &server,
+        .port = conn->port,
+    };
+
+    conn->state = UPLINK_SLOT_FREE;
+    if (started) {
+        stats.in_flight--;
+        if (result == UPLINK_RESULT_OK) {
+            stats.completed++;
+        } else if (result == UPLINK_RESULT_TIMEOUT) {
+            stats.timed_out++;
+        } else {
+            stats.failed++;
+        }
+    }
+
+    if (result_fn) {
+        result_fn(arg, &resp);
+    }
+    return ret;
+}
+
+// ==================== Callbacks TCP ====================
+static err_t uplink_sent(void *arg, struct tcp_pcb *pcb, u16_t len) {
+    uplink_conn_t *conn = (uplink_conn_t *)arg;
+
+    conn->acked += len;
+    if (conn->request && conn->acked >= conn->request->tot_len) {
+        uplink_release_request(conn);
+    }
+    return ERR_OK;
+}
+
+static err_t uplink_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+    uplink_conn_t *conn = (uplink_conn_t *)arg;
+
+    if (!p) {
+        return uplink_finish(conn, conn->http_status ? UPLINK_RESULT_OK : UPLINK_RESULT_ERR_CLOSED);
+    }
+
+    // A resposta pode chegar em vários segmentos: processa byte a byte.
+    // "HTTP/1.1 200 ..." - o código está nos bytes 9..11 da primeira linha
+    for (struct pbuf *q = p; q; q = q->next) {
+        const char *data = (const char *)q->payload;
+        for (u16_t i = 0; i < q->len; i++, conn->resp_pos++) {
+            char c = data[i];
+            if (conn->resp_pos >= 9 && conn->resp_pos < 12) {
+                conn->http_status = conn->http_status * 10 + (uint16_t)(c - '0');
+            } else if (conn->eoh_match < 4) {
+                static const char eoh[] = "\r\n\r\n";
+                conn->eoh_match = c == eoh[conn->eoh_match] ? conn->eoh_match + 1 : (c == '\r');
+            } else if (conn->body_len < UPLINK_RESP_BODY_MAX) {
+                conn->body[conn->body_len++] = c;
+            }
+        }
+    }
+
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+    return ERR_OK;
+}
+
+static err_t uplink_poll(void *arg, struct tcp_pcb *pcb) {
+    uplink_conn_t *conn = (uplink_conn_t *)arg;
+
+    if (++conn->poll_ticks >= conn->timeout_ticks) {
+        return uplink_finish(conn, UPLINK_RESULT_TIMEOUT);
+    }
+    return ERR_OK;
+}
+
+static void uplink_err(void *arg, err_t err) {
+    uplink_conn_t *conn = (uplink_conn_t *)arg;
+
+    // O pcb já foi liberado pelo lwIP (e com ele os segmentos pendentes)
+    conn->pcb = NULL;
+    uplink_finish(conn, conn->http_status ? UPLINK_RESULT_ERR_CLOSED : UPLINK_RESULT_ERR_CONNECT);
+}
+
+static err_t uplink_connected(void *arg, struct tcp_pcb *pcb, err_t err) {
+    uplink_conn_t *conn = (uplink_conn_t *)arg;
+
+    if (err != ERR_OK) {
+        return uplink_finish(conn, UPLINK_RESULT_ERR_CONNECT);
+    }
+
+    conn->state = UPLINK_SLOT_WAITING;
+    for (struct pbuf *q = conn->request; q; q = q->next) {
+        u8_t flags = q->next ? TCP_WRITE_FLAG_MORE : 0;
+        if (tcp_write(pcb, q->payload, q->len, flags) != ERR_OK) {
+            return uplink_finish(conn, UPLINK_RESULT_ERR_MEM);
+        }
+    }
+    tcp_output(pcb);
+    return ERR_OK;
+}
+
+// Escreve o IP do servidor em notação decimal
+static void uplink_put_host(uplink_writer_t *w, const ip_addr_t *server) {
+    for (int i = 0; i < 4; i++) {
+        if (i) {
+            uplink_put_char(w, '.');
+        }
+        uplink_put_uint(w, ((const uint8_t *)&ip_2_ip4(server)->addr)[i]);
+    }
+}
+
+static bool uplink_writer_finish(uplink_writer_t *w) {
+    if (w->overflow) {
+        uplink_writer_discard(w);
+        return false;
+    }
+    pbuf_realloc(w->head, w->length);
+    return true;
+}
+
+// Abre a conexão em um slot livre e entrega a cadeia ao TCP; a cadeia passa
+// a pertencer ao uplink
+static err_t uplink_start(struct pbuf *request, uint16_t samples,
+                          const ip_addr_t *server, uint16_t port,
+                          uplink_result_fn result_fn, void *arg) {
+    cyw43_arch_lwip_begin();
+    uplink_conn_t *conn = uplink_slot_alloc();
+    if (!conn) {
+        stats.table_full++;
+        cyw43_arch_lwip_end();
+        pbuf_free(request);
+        return ERR_INPROGRESS;
+    }
+
+    struct tcp_pcb *pcb = tcp_new_ip_type(IP_GET_TYPE(server));
+    if (!pcb) {
+        cyw43_arch_lwip_end();
+        pbuf_free(request);
+        return ERR_MEM;
+    }
+
+    memset(conn, 0, sizeof(*conn));
+    conn->state = UPLINK_SLOT_CONNECTING;
+    conn->pcb = pcb;
+    conn->request = request;
+    conn->timeout_ticks = UPLINK_POLL_TIMEOUT;
+    conn->start_ms = to_ms_since_boot(get_absolute_time());
+    ip_addr_copy(conn->server, *server);
+    conn->port = port;
+    conn->result_fn = result_fn;
+    conn->arg = arg;
+
+    tcp_arg(pcb, conn);
+    tcp_err(pcb, uplink_err);
+    tcp_recv(pcb, uplink_recv);
+    tcp_sent(pcb, uplink_sent);
+    tcp_poll(pcb, uplink_poll, UPLINK_POLL_INTERVAL);
+
+    uint32_t tot_len = request->tot_len;
+    err_t err = tcp_connect(pcb, server, port, uplink_connected);
+    if (err != ERR_OK) {
+        // Falha síncrona: o chamador recebe o erro, sem callback nem contagem
+        conn->result_fn = NULL;
+        uplink_finish(conn, UPLINK_RESULT_ERR_CONNECT);
+    } else {
+        conn->started = true;
+        stats.requests++;
+        stats.in_flight++;
+        stats.samples += samples;
+        stats.bytes_serialized += tot_len;
+    }
+    cyw43_arch_lwip_end();
+    return err;
+}
+
+err_t uplink_send(uplink_writer_t *w, const ip_addr_t *server, uint16_t port,
+                  uplink_result_fn result_fn, void *arg) {
+    uplink_put_str(w, " HTTP/1.1\r\nHost: ");
+    uplink_put_host(w, server);
+    uplink_put_str(w, "\r\nConnection: close\r\n\r\n");
+
+    if (!uplink_writer_finish(w)) {
+        return ERR_MEM;
+    }
+    struct pbuf *request = w->head;
+    w->head = NULL;
+    return uplink_start(request, 1, server, port, result_fn, arg);
+}
+
+err_t uplink_send_post(uplink_writer_t *body, const char *path, uint16_t samples,
+                       const ip_addr_t *server, uint16_t port,
+                       uplink_result_fn result_fn, void *arg) {
+    uplink_writer_t hdr;
+
+    if (!uplink_writer_finish(body)) {
+        return ERR_MEM;
+    }
+    if (!uplink_begin_body(&hdr)) {
+        uplink_writer_discard(body);
+        return ERR_MEM;
+    }
+
+    uplink_put_str(&hdr, "POST ");
+    uplink_put_str(&hdr, path);
+    uplink_put_str(&hdr, " HTTP/1.1\r\nHost: ");
+    uplink_put_host(&hdr, server);
+    uplink_put_str(&hdr, "\r\nContent-Type: application/octet-stream\r\nContent-Length: ");
+    uplink_put_uint(&hdr, body->length);
+    uplink_put_str(&hdr, "\r\nConnection: close\r\n\r\n");
+
+    if (!uplink_writer_finish(&hdr)) {
+        uplink_writer_discard(body);
+        return ERR_MEM;
+    }
+
+    // Cabeçalho e corpo encadeados sem copiar o corpo
+    pbuf_cat(hdr.head, body->head);
+    body->head = NULL;
+    return uplink_start(hdr.head, samples, server, port, result_fn, arg);
+}
+
+bool uplink_response_get_uint(const uplink_response_t *resp, const char *key, uint32_t *value) {
+    size_t key_len = strlen(key);
+    const char *p = resp->body;
+    const char *end = resp->body + resp->body_len;
+
+    while (p < end) {
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) {
+            eol = end;
+        }
+        if ((size_t)(eol - p) > key_len && memcmp(p, key, key_len) == 0 && p[key_len] == '=') {
+            const char *d = p + key_len + 1;
+            if (d == eol || *d < '0' || *d > '9') {
+                return false;
+            }
+            uint32_t v = 0;
+            for (; d < eol && *d >= '0' && *d <= '9'; d++) {
+                v = v * 10 + (uint32_t)(*d - '0');
+            }
+            *value = v;
+            return true;
+        }
+        p = eol + 1;
+    }
+    return false;
+}
+
+// Seção crítica curta em vez do lock do lwIP: também é chamada pelo httpd,
+// que já roda na thread do lwIP
+void uplink_get_stats(uplink_stats_t *out) {
+    SYS_ARCH_DECL_PROTECT(lev);
+    SYS_ARCH_PROTECT(lev);
+    *out = stats;
+    SYS_ARCH_UNPROTECT(lev);
+}
+
+bool uplink_can_send(void) {
+    return stats.in_flight < UPLINK_MAX_INFLIGHT;
+}
+
+uint32_t uplink_in_flight(void) {
+    return stats.in_flight;
+}
+
+#if UPLINK_LEGACY_BENCH > 0
+// ==================== Comparação com o Caminho Antigo ====================
+// Com -Wl,--wrap=tcp_write toda chamada de fora do tcp_out.c passa por aqui
+err_t __real_tcp_write(struct tcp_pcb *pcb, const void *data, u16_t len, u8_t apiflags);
+
+static volatile uint32_t tcp_copied;
+
+err_t __wrap_tcp_write(struct tcp_pcb *pcb, const void *data, u16_t len, u8_t apiflags) {
+    err_t err = __real_tcp_write(pcb, data, len, apiflags);
+    if (err == ERR_OK && (apiflags & TCP_WRITE_FLAG_COPY)) {
+        tcp_copied += len;
+    }
+    return err;
+}
+
+uint32_t uplink_tcp_copied_bytes(void) {
+    return tcp_copied;
+}
+#endif
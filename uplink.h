@@ -0,0 +1,101 @@
+#ifndef UPLINK_H
+#define UPLINK_H
+
+#include "lwip/ip_addr.h"
+#include "lwip/err.h"
+#include "lwip/pbuf.h"
+
+// Pool dedicado de buffers de requisição (pbufs customizados)
+#define UPLINK_BUF_SIZE         192
+// Cada requisição em curso prende ao menos 2 buffers (cabeçalho + corpo)
+// até o ACK, por isso o pool acompanha o tamanho da tabela
+#define UPLINK_MAX_INFLIGHT     3
+#define UPLINK_POOL_SIZE        (UPLINK_MAX_INFLIGHT * 2 + 2)
+#define UPLINK_TIMEOUT_MS       5000
+// Início do corpo da resposta guardado para o callback (ACK, controle)
+#define UPLINK_RESP_BODY_MAX    96
+
+// Comparação com o caminho antigo (snprintf + httpc_get_file) no boot do
+// uplink, N amostras pelos dois caminhos (-DUPLINK_LEGACY_BENCH=20); o link
+// embrulha o tcp_write() (-Wl,--wrap=tcp_write) para contar o que o lwIP copia
+#ifndef UPLINK_LEGACY_BENCH
+#define UPLINK_LEGACY_BENCH     0
+#endif
+
+typedef enum {
+	UPLINK_RESULT_OK = 0,
+	UPLINK_RESULT_ERR_CONNECT,
+	UPLINK_RESULT_ERR_CLOSED,
+	UPLINK_RESULT_ERR_MEM,
+	UPLINK_RESULT_TIMEOUT,
+} uplink_result_t;
+
+typedef struct {
+	uplink_result_t result;
+	uint16_t http_status;       // 0 se nenhuma resposta chegou
+	uint32_t latency_ms;        // tcp_connect() -> fim da requisição
+	const char *body;           // Corpo (truncado em UPLINK_RESP_BODY_MAX), sem '\0'
+	uint16_t body_len;
+	const ip_addr_t *server;    // Destino da requisição
+	uint16_t port;
+} uplink_response_t;
+
+// Chamado no contexto do lwIP quando a requisição termina
+typedef void (*uplink_result_fn)(void *arg, const uplink_response_t *resp);
+
+// Serializa a requisição diretamente na cadeia de pbufs do pool
+typedef struct {
+	struct pbuf *head;
+	struct pbuf *cur;
+	uint16_t offset;    // Posição de escrita no pbuf atual
+	uint16_t length;    // Total serializado
+	bool overflow;      // Pool esgotado durante a escrita
+} uplink_writer_t;
+
+typedef struct {
+	uint32_t requests;
+	uint32_t samples;
+	uint32_t bytes_serialized;      // Escritos uma única vez no pool; o tcp_write() não copia
+	uint32_t pool_exhausted;
+	uint32_t in_flight;             // Slots ocupados na tabela de requisições
+	uint32_t completed;             // Resposta HTTP recebida (qualquer status)
+	uint32_t failed;                // Conexão recusada/fechada ou falta de memória
+	uint32_t timed_out;             // Sem resposta em UPLINK_TIMEOUT_MS
+	uint32_t table_full;            // Envios recusados por falta de slot
+} uplink_stats_t;
+
+void uplink_init(void);
+
+bool uplink_begin_get(uplink_writer_t *w, const char *path);
+bool uplink_begin_body(uplink_writer_t *w);
+void uplink_put_str(uplink_writer_t *w, const char *str);
+void uplink_put_uint(uplink_writer_t *w, uint32_t value);
+void uplink_put_uint64(uplink_writer_t *w, uint64_t value);
+void uplink_put_byte(uplink_writer_t *w, uint8_t byte);
+void uplink_writer_discard(uplink_writer_t *w);
+
+// GET: completa a requisição iniciada com uplink_begin_get()
+err_t uplink_send(uplink_writer_t *w, const ip_addr_t *server, uint16_t port,
+                  uplink_result_fn result_fn, void *arg);
+
+// POST: envia o corpo serializado com uplink_begin_body() (application/octet-stream)
+err_t uplink_send_post(uplink_writer_t *body, const char *path, uint16_t samples,
+                       const ip_addr_t *server, uint16_t port,
+                       uplink_result_fn result_fn, void *arg);
+
+// Procura "chave=valor" (uma por linha) no corpo da resposta
+bool uplink_response_get_uint(const uplink_response_t *resp, const char *key, uint32_t *value);
+
+void uplink_get_stats(uplink_stats_t *stats);
+
+#if UPLINK_LEGACY_BENCH > 0
+// Bytes passados ao tcp_write() com TCP_WRITE_FLAG_COPY desde o boot (de
+// qualquer chamador, inclusive httpc e httpd)
+uint32_t uplink_tcp_copied_bytes(void);
+#endif
+
+// Há slot livre na tabela? (ERR_INPROGRESS em uplink_send*() caso contrário)
+bool uplink_can_send(void);
+uint32_t uplink_in_flight(void);
+
+#endif // UPLINK_H
@@ -0,0 +1,90 @@
+/**
+ * Cache de conexão WiFi em flash
+ *
+ * Guarda canal, BSSID e configuração IP do último join bem-sucedido no
+ * último setor da flash, para que o próximo boot tente um rejoin direcionado
+ * (sem varredura e sem DHCP) antes do caminho completo.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "pico/flash.h"
+
+#include "wifi_cache.h"
+
+#define WIFI_CACHE_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+#define WIFI_CACHE_FLASH_TIMEOUT_MS 100
+
+static uint32_t fnv1a(const uint8_t *data, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t wifi_cache_checksum(const wifi_cache_t *cache) {
+    return fnv1a((const uint8_t *)cache, offsetof(wifi_cache_t, checksum));
+}
+
+static const wifi_cache_t *wifi_cache_flash(void) {
+    return (const wifi_cache_t *)(XIP_BASE + WIFI_CACHE_FLASH_OFFSET);
+}
+
+// Executado com a outra CPU/interrupções paradas por flash_safe_execute()
+static void wifi_cache_flash_write(void *param) {
+    const uint8_t *page = (const uint8_t *)param;
+    flash_range_erase(WIFI_CACHE_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    if (page) {
+        flash_range_program(WIFI_CACHE_FLASH_OFFSET, page, FLASH_PAGE_SIZE);
+    }
+}
+
+bool wifi_cache_load(wifi_cache_t *cache, const char *ssid) {
+    const wifi_cache_t *stored = wifi_cache_flash();
+
+    if (stored->magic != WIFI_CACHE_MAGIC || stored->version != WIFI_CACHE_VERSION) {
+        return false;
+    }
+    if (stored->checksum != wifi_cache_checksum(stored)) {
+        return false;
+    }
+    if (stored->ssid_hash != fnv1a((const uint8_t *)ssid, strlen(ssid))) {
+        return false;
+    }
+    if (stored->channel == 0 || stored->ip == 0) {
+        return false;
+    }
+
+    memcpy(cache, stored, sizeof(*cache));
+    return true;
+}
+
+bool wifi_cache_store(wifi_cache_t *cache, const char *ssid) {
+    static uint8_t page[FLASH_PAGE_SIZE];
+
+    cache->magic = WIFI_CACHE_MAGIC;
+    cache->version = WIFI_CACHE_VERSION;
+    cache->ssid_hash = fnv1a((const uint8_t *)ssid, strlen(ssid));
+    cache->reserved = 0;
+    cache->checksum = wifi_cache_checksum(cache);
+
+    // Evita desgaste da flash quando nada mudou desde o último boot
+    if (memcmp(wifi_cache_flash(), cache, sizeof(*cache)) == 0) {
+        return true;
+    }
+
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, cache, sizeof(*cache));
+    return flash_safe_execute(wifi_cache_flash_write, page, WIFI_CACHE_FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+void wifi_cache_invalidate(void) {
+    if (wifi_cache_flash()->magic != WIFI_CACHE_MAGIC) {
+        return;
+    }
+    flash_safe_execute(wifi_cache_flash_write, NULL, WIFI_CACHE_FLASH_TIMEOUT_MS);
+}
@@ -0,0 +1,29 @@
+#ifndef WIFI_CACHE_H
+#define WIFI_CACHE_H
+
+#include "pico/stdlib.h"
+
+// Último setor da flash reservado para o cache de conexão WiFi
+#define WIFI_CACHE_MAGIC        0x57464331  // "WFC1"
+#define WIFI_CACHE_VERSION      1
+
+// Parâmetros do último join bem-sucedido (endereços IPv4 em ordem de rede,
+// no mesmo formato de ip4_addr_t.addr)
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t ssid_hash;      // Invalida o cache se o SSID configurado mudar
+	uint8_t bssid[6];
+	uint8_t channel;
+	uint8_t reserved;
+	uint32_t ip;
+	uint32_t netmask;
+	uint32_t gateway;
+	uint32_t checksum;
+} wifi_cache_t;
+
+bool wifi_cache_load(wifi_cache_t *cache, const char *ssid);
+bool wifi_cache_store(wifi_cache_t *cache, const char *ssid);
+void wifi_cache_invalidate(void);
+
+#endif // WIFI_CACHE_H